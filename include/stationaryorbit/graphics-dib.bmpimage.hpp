@@ -20,3 +20,6 @@
 #include "graphics-dib/dibcorebitmap.hpp"
 #include "graphics-dib/dibheaders.hpp"
 #include "graphics-dib/dibinfobitmap.hpp"
+#include "graphics-dib/dibpushdecoder.hpp"
+#include "graphics-dib/dibscanlinereader.hpp"
+#include "graphics-dib/dibscanlinewriter.hpp"
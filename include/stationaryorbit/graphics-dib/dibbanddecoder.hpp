@@ -0,0 +1,79 @@
+//	stationaryorbit/graphics-dib/dibbanddecoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibbanddecoder__
+#define __stationaryorbit_graphics_dib_dibbanddecoder__
+#include <functional>
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibloader.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	画像を水平ラインの帯に分割し、帯単位でデコードを行うヘルパークラスです。
+	///	@note
+	///	複数のスレッドを使用する場合、各スレッドは @a DIBLoader::CreateReader で構築した独立した読み込みを使用します。
+	///	ビットマップの @a SetDecodeConcurrency で指定したスレッド数はこのクラスで解決されます。
+	class DIBBandDecodeHelper final
+	{
+		DIBBandDecodeHelper() = delete;
+		DIBBandDecodeHelper(const DIBBandDecodeHelper&) = delete;
+		DIBBandDecodeHelper(DIBBandDecodeHelper&&) = delete;
+		~DIBBandDecodeHelper() = delete;
+	public:
+		///	1つの帯に含まれる水平ラインの数。
+		static constexpr int32_t BandHeight = 64;
+		///	帯のデコードを行う関数。
+		///	@a loader を使用して [y0, y1) の範囲の水平ラインをデコードし、画像上の並び順で @a dest に格納します。
+		typedef std::function<void(DIBLoader& loader, int32_t y0, int32_t y1, RGB8_t* dest)> BandFunction;
+		///	デコードされた1水平ラインを受け取る関数。
+		///	複数のスレッドを使用する場合、異なる水平ラインについて並行して呼び出されます。
+		typedef std::function<void(int32_t y, const RGB8_t* row)> RowFunction;
+
+		///	使用するスレッド数を解決します。
+		///	@param	threads
+		///	要求されたスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@param	bands
+		///	デコードする帯の数。
+		[[nodiscard]] static size_t ResolveThreadCount(size_t threads, size_t bands);
+		///	指定された範囲の水平ラインを帯単位でデコードします。
+		///	@param	loader
+		///	読み込みに使用する @a DIBLoader 。
+		///	@param	width
+		///	デコードする水平ラインの幅。
+		///	@param	top
+		///	デコードする範囲の先頭の水平ラインの画像上のY座標。
+		///	@param	bottom
+		///	デコードする範囲の末尾の次の水平ラインの画像上のY座標。
+		///	@param	threads
+		///	使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@param	decode
+		///	帯のデコードを行う関数。
+		///	@param	sink
+		///	デコードされた水平ラインを受け取る関数。
+		///	@return
+		///	実際にデコードを行ったスレッド数(呼び出し元のスレッドを含む)。
+		///	次の場合は要求されたスレッド数にかかわらず、呼び出し元のスレッドのみでデコードを行い 1 を返します。
+		///	- 解決されたスレッド数が1以下である(帯が1つしかない場合を含む)。
+		///	- @a loader の @a DIBLoader::CreateReader が @a nullptr を返した(独立した読み込みをサポートしない)。
+		///	- @a DIBLoader::CreateReader で必要な数の読み込みを構築できなかった。
+		///	スレッドの起動に失敗した場合は、起動できたスレッドのみで残りの帯を処理します。
+		///	@exception
+		///	いずれかのスレッドで例外が発生した場合、残りの帯のデコードを中止し、最初に発生した例外を呼び出し元のスレッドでスローします。
+		static size_t Decode(DIBLoader& loader, int32_t width, int32_t top, int32_t bottom, size_t threads, const BandFunction& decode, const RowFunction& sink);
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibbanddecoder__
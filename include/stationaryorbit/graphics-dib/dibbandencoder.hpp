@@ -0,0 +1,61 @@
+//	stationaryorbit/graphics-dib/dibbandencoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibbandencoder__
+#define __stationaryorbit_graphics_dib_dibbandencoder__
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibloader.hpp"
+#include "dibrowconverter.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	画像を水平ラインの帯に分割し、帯単位でピクセル配列の書き込みを行うヘルパークラスです。
+	///	@note
+	///	帯ごとの色の変換は複数のスレッドで並行して行われます。
+	///	@a DIBLoader への書き込みは、ファイル上の並び順に1つの帯ずつ、1回の書き込みで行われます。
+	class DIBBandEncodeHelper final
+	{
+		DIBBandEncodeHelper() = delete;
+		DIBBandEncodeHelper(const DIBBandEncodeHelper&) = delete;
+		DIBBandEncodeHelper(DIBBandEncodeHelper&&) = delete;
+		~DIBBandEncodeHelper() = delete;
+	public:
+		///	1つの帯に含まれる水平ラインの数。
+		static constexpr int32_t BandHeight = 64;
+
+		///	画像をピクセル配列に変換し、 @a DIBLoader に書き込みます。
+		///	@param	loader
+		///	書き込み先の @a DIBLoader 。
+		///	@param	offset
+		///	ピクセル配列の位置。
+		///	@param	size
+		///	ピクセル配列の大きさ。
+		///	@param	packer
+		///	色をピクセルデータに変換する @a DIBRowConverter 。
+		///	@param	image
+		///	書き込む画像。
+		///	複数のスレッドを使用する場合、異なる位置の値が並行して取得されます。
+		///	@param	threads
+		///	使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@exception	std::invalid_argument
+		///	@a image が @a DIBImageView で、 @a threads に1以外が指定されました。
+		///	@exception
+		///	いずれかのスレッドで例外が発生した場合、残りの帯の書き込みを中止し、最初に発生した例外を呼び出し元のスレッドでスローします。
+		static void Encode(DIBLoader& loader, size_t offset, const DisplayRectSize& size, const DIBRowConverter& packer, const Image<RGB8_t>& image, size_t threads);
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibbandencoder__
@@ -0,0 +1,108 @@
+//	stationaryorbit/graphics-dib/dibbitfields
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibbitfields__
+#define __stationaryorbit_graphics_dib_dibbitfields__
+#include "stationaryorbit/graphics-core.color.hpp"
+#include "dibheaders.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	色マスクの1チャネル分のビット位置を表します。
+	///	@note
+	///	取り出しと格納に必要なシフト量・倍率は構築時に求められます。
+	struct DIBChannelBitField final
+	{
+		///	チャネルのマスク。
+		uint32_t Mask;
+		///	チャネルの最下位ビットの位置。
+		uint32_t Shift;
+		///	チャネルのビット幅。
+		uint32_t Width;
+		///	取り出した値を8ビット以下に切り詰めるための右シフト量。
+		uint32_t Reduce;
+		///	8ビット以下の値を上位ビットの複製により8ビットに拡張するための倍率(16ビット固定小数点数)。
+		uint32_t Scale;
+
+		///	空のマスクで @a DIBChannelBitField を構築します。
+		constexpr DIBChannelBitField() : Mask(), Shift(), Width(), Reduce(), Scale() {}
+		///	マスクから @a DIBChannelBitField を構築します。
+		///	@exception	InvalidDIBFormatException
+		///	マスクのビットが連続していません。
+		explicit DIBChannelBitField(uint32_t mask);
+
+		///	ピクセルデータからこのチャネルの値を8ビットに変換して取り出します。
+		///	マスクが空の場合は 0 を返します。
+		[[nodiscard]] constexpr uint8_t Extract(uint32_t data) const { return uint8_t(((((data & Mask) >> Shift) >> Reduce) * Scale) >> 16); }
+		///	8ビットの値をこのチャネルのビット位置に格納した値を取得します。
+		[[nodiscard]] constexpr uint32_t Insert(uint8_t value) const { return (((Width <= 8)?(uint32_t(value) >> (8 - Width)):(uint32_t(value) << (Width - 8))) << Shift) & Mask; }
+	};
+	///	ビットフィールド形式(BITFIELDS, ALPHABITFIELDS)のピクセルデータと色の相互変換を行います。
+	class DIBBitFields final
+	{
+	public:
+		///	変換に専用の実装を使用できる色マスクの配置。
+		enum class Layouts
+		{
+			///	専用の実装を持たない配置。
+			Generic,
+			///	16ビット 5-5-5 (0x7C00, 0x03E0, 0x001F)。
+			RGB555,
+			///	16ビット 5-6-5 (0xF800, 0x07E0, 0x001F)。
+			RGB565,
+			///	32ビット X8R8G8B8 または A8R8G8B8 (0x00FF0000, 0x0000FF00, 0x000000FF)。
+			XRGB8888,
+		};
+	private:
+		DIBChannelBitField red;
+		DIBChannelBitField green;
+		DIBChannelBitField blue;
+		DIBChannelBitField alpha;
+		Layouts layout;
+	public:
+		///	空のマスクで @a DIBBitFields を構築します。
+		DIBBitFields();
+		///	RGBの色マスクから @a DIBBitFields を初期化します。
+		///	@exception	InvalidDIBFormatException
+		///	マスクのビットが連続していません。
+		explicit DIBBitFields(const DIBRGBColorMask& mask);
+		///	RGBAの色マスクから @a DIBBitFields を初期化します。
+		///	@exception	InvalidDIBFormatException
+		///	マスクのビットが連続していません。
+		explicit DIBBitFields(const DIBRGBAColorMask& mask);
+
+		[[nodiscard]] const DIBChannelBitField& Red() const { return red; }
+		[[nodiscard]] const DIBChannelBitField& Green() const { return green; }
+		[[nodiscard]] const DIBChannelBitField& Blue() const { return blue; }
+		[[nodiscard]] const DIBChannelBitField& Alpha() const { return alpha; }
+		///	色マスクの配置を取得します。
+		[[nodiscard]] Layouts Layout() const { return layout; }
+
+		///	ピクセルデータを色に変換します。
+		[[nodiscard]] RGB8_t ToRGB(uint32_t data) const
+		{
+			return RGB8_t(Proportion8_t(red.Extract(data), 0xFF), Proportion8_t(green.Extract(data), 0xFF), Proportion8_t(blue.Extract(data), 0xFF));
+		}
+		///	色をピクセルデータに変換します。
+		///	α成分のマスクを持つ場合、α成分は不透明として格納されます。
+		[[nodiscard]] uint32_t ToPixel(const RGB8_t& color) const
+		{
+			return red.Insert(color.R().Data().Data()) | green.Insert(color.G().Data().Data()) | blue.Insert(color.B().Data().Data()) | alpha.Mask;
+		}
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibbitfields__
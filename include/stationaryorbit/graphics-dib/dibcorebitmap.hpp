@@ -23,6 +23,14 @@
 #include <functional>
 #include <variant>
 #include "dibloader.hpp"
+#include "dibrowconverter.hpp"
+#include "dibrowbatch.hpp"
+#include "dibtypeddecoder.hpp"
+#include "dibbanddecoder.hpp"
+#include "dibbandencoder.hpp"
+#include "dibpixelcursor.hpp"
+#include "dibtilecache.hpp"
+#include "dibimageview.hpp"
 namespace zawa_ch::StationaryOrbit::Graphics::DIB
 {
 	class DIBCoreBitmapDecoder
@@ -41,13 +49,18 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	現在の読み込み位置。
 		int64_t current;
 		///	現在の値。
-		ValueType current_value;
+		///	@a Current() で最初に要求されるまで読み込まれません。
+		mutable std::optional<ValueType> current_value;
 		///	各ピクセルのデータ長。
 		DIBBitDepth bitdepth;
 		///	1ピクセルのデータ長(バイト単位)。
 		const size_t pixellength;
 		///	ストライド(1水平軸ラインのデータ長)。
 		const size_t stridelength;
+		///	1水平軸ラインのパディングを含まないデータ長。
+		const size_t rowlength;
+		///	水平ライン単位の読み込みに使用するバッファ。
+		std::vector<uint8_t> rowbuffer;
 	public:
 		DIBCoreBitmapDecoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size);
 		virtual ~DIBCoreBitmapDecoder() = default;
@@ -75,6 +88,8 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	現在の位置を画像上での位置で取得します。
 		[[nodiscard]] DisplayPoint CurrentPos() const;
 		///	現在の位置にあるオブジェクトを取得します。
+		///	@note
+		///	値は最初に要求された時点で読み込まれ、位置を移動するまで保持されます。
 		[[nodiscard]] ValueType Current() const;
 		///	現在の位置にオブジェクトを書き込みます。
 		void Write(const ValueType& value);
@@ -82,22 +97,122 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] IteratorTraits::IteratorDiff_t Distance(const DIBCoreBitmapDecoder& other) const;
 		[[nodiscard]] bool Equals(const DIBCoreBitmapDecoder& other) const;
 		[[nodiscard]] int Compare(const DIBCoreBitmapDecoder& other) const;
+		///	1水平軸ラインのデータ長(バイト単位)を取得します。
+		[[nodiscard]] size_t StrideLength() const { return stridelength; }
+		///	各ピクセルのデータ長を取得します。
+		[[nodiscard]] DIBBitDepth BitDepth() const { return bitdepth; }
+		///	このオブジェクトと同じピクセル配列を読み書きする、ビット幅を静的に指定したデコーダーを取得します。
+		///	@exception	InvalidOperationException
+		///	@a Depth がこのオブジェクトの各ピクセルのデータ長と一致しません。
+		template<DIBBitDepth Depth>
+		[[nodiscard]] DIBTypedDecoder<Depth> Typed() const
+		{
+			if (Depth != bitdepth) { throw InvalidOperationException("指定されたビット幅がこのオブジェクトと一致しません。"); }
+			return DIBTypedDecoder<Depth>(loader, offset, size);
+		}
+		///	指定された水平ラインの生データを1回の読み込みで取得します。
+		///	@param	y
+		///	読み込む水平ラインの画像上のY座標。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a StrideLength() の長さの領域が確保されている必要があります。
+		///	ストライド末尾のパディングは読み込まれません。
+		void ReadRow(int32_t y, uint8_t* dest);
+		///	指定された範囲の水平ラインの生データを1回の読み込みで取得します。
+		///	@param	y0
+		///	読み込む範囲の先頭の水平ラインの画像上のY座標。
+		///	@param	y1
+		///	読み込む範囲の末尾の次の水平ラインの画像上のY座標。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a StrideLength()*(y1-y0) の長さの領域が確保されている必要があります。
+		///	データはファイル上の並び順(画像の下から上)で格納されます。
+		///	最後の水平ラインのパディングは読み込まれません。
+		void ReadRows(int32_t y0, int32_t y1, uint8_t* dest);
+		///	指定された水平ラインを読み込み、色に変換します。
+		///	@param	y
+		///	読み込む水平ラインの画像上のY座標。
+		///	@param	dest
+		///	変換した色の格納先。
+		///	画像の幅の長さの領域が確保されている必要があります。
+		///	@param	converter
+		///	変換に使用する @a DIBRowConverter 。
+		void DecodeRow(int32_t y, RGB8_t* dest, const DIBRowConverter& converter);
+		///	指定された範囲の水平ラインを1回の読み込みで取得し、色に変換します。
+		///	@param	y0
+		///	読み込む範囲の先頭の水平ラインの画像上のY座標。
+		///	@param	y1
+		///	読み込む範囲の末尾の次の水平ラインの画像上のY座標。
+		///	@param	dest
+		///	変換した色の格納先。
+		///	画像の幅*(y1-y0) の長さの領域が確保されている必要があります。
+		///	色は画像上の並び順(画像の上から下)で格納されます。
+		///	@param	converter
+		///	変換に使用する @a DIBRowConverter 。
+		void DecodeRows(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter);
+		///	指定された矩形領域のピクセルを読み込み、色に変換します。
+		///	@param	area
+		///	読み込む領域。
+		///	@param	dest
+		///	変換した色の格納先。
+		///	@a area の幅*高さ の長さの領域が確保されている必要があります。
+		///	色は画像上の並び順(画像の上から下)で格納されます。
+		///	@param	converter
+		///	変換に使用する @a DIBRowConverter 。
+		///	@note
+		///	各水平ラインについて、領域に含まれるピクセルのデータのみを1回の読み込みで取得します。
+		///	@exception	std::out_of_range
+		///	指定された領域はこの画像領域を超えています。
+		void DecodeRegion(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter);
+		///	指定された領域がこの画像領域に収まっているかを検証します。
+		///	検証した領域の内側では、 @a ReadRowsUnchecked 、 @a DecodeRowsUnchecked および @a GetUnchecked を範囲の検査なしで使用できます。
+		///	@exception	std::out_of_range
+		///	指定された領域はこの画像領域を超えています。
+		void ValidateRegion(const DisplayRectangle& area) const;
+		///	範囲の検査を行わずに、指定された範囲の水平ラインの生データを1回の読み込みで取得します。
+		///	@note
+		///	[y0, y1) は @a ValidateRegion で検証した領域に含まれている必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		///	引数と格納先は @a ReadRows と同じです。
+		void ReadRowsUnchecked(int32_t y0, int32_t y1, uint8_t* dest);
+		///	範囲の検査を行わずに、指定された範囲の水平ラインを1回の読み込みで取得し、色に変換します。
+		///	@note
+		///	[y0, y1) は @a ValidateRegion で検証した領域に含まれている必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		///	引数と格納先は @a DecodeRows と同じです。
+		void DecodeRowsUnchecked(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter);
+		///	範囲の検査を行わずに、指定された位置のピクセルを読み込みます。
+		///	現在の位置と保持している値は変更されません。
+		///	@note
+		///	@a pos は @a ValidateRegion で検証した領域に含まれている必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		[[nodiscard]] ValueType GetUnchecked(const DisplayPoint& pos) const;
+		///	範囲の検査を行わずに、指定された矩形領域のピクセルを読み込み、色に変換します。
+		///	@note
+		///	@a area は @a ValidateRegion で検証した領域である必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		///	引数と格納先は @a DecodeRegion と同じです。
+		void DecodeRegionUnchecked(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter);
 	private:
-		[[nodiscard]] ValueType Get(size_t index);
+		///	指定した範囲のデータを取得します。
+		///	ローダーが @a DIBLoader::Peek で直接参照できる場合はその領域を、それ以外の場合は @a rowbuffer に読み込んだ領域を返します。
+		///	返された領域は次にこのオブジェクトで読み込みを行うまで有効です。
+		[[nodiscard]] const uint8_t* FetchBytes(size_t pos, size_t length);
+		///	@note
+		///	@a index は画像の範囲内である必要があります。範囲の検査は呼び出し元で行います。
+		[[nodiscard]] ValueType Get(size_t index) const;
 		[[nodiscard]] size_t ResolveIndex(const DisplayPoint& pos) const;
 		[[nodiscard]] DisplayPoint ResolvePos(size_t index) const;
 		[[nodiscard]] size_t ResolveOffset(const DisplayPoint& pos) const;
 		[[nodiscard]] size_t ResolveOffset(size_t index) const;
+		[[nodiscard]] uint32_t ExtractPacked(uint8_t data, size_t index) const;
+		[[nodiscard]] uint8_t InsertPacked(uint8_t data, uint32_t value, size_t index) const;
 	};
 	class DIBCoreBitmapEncoder
 	{
 	public:
 		typedef std::variant<DIBPixelData<DIBBitDepth::Bit1>, DIBPixelData<DIBBitDepth::Bit4>, DIBPixelData<DIBBitDepth::Bit8>, DIBPixelData<DIBBitDepth::Bit24>> ValueType;
 	private:
-		///	書き込みを行う @a DIBLoader への参照。
-		DIBLoader& loader;
-		///	書き込み先のデータのオフセット。
-		size_t offset;
 		///	画像の大きさ。
 		DisplayRectSize size;
 		///	全体の要素数。
@@ -110,13 +225,48 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		const size_t pixellength;
 		///	ストライド(1水平軸ラインのデータ長)。
 		const size_t stridelength;
+		///	書き込み待ちの水平ラインを格納するバッファ。
+		DIBRowBatch batch;
 	public:
-		DIBCoreBitmapEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size);
-		virtual ~DIBCoreBitmapEncoder() = default;
+		///	@a DIBCoreBitmapEncoder を初期化します。
+		///	@param	loader
+		///	書き込みを行う @a DIBLoader 。
+		///	@param	offset
+		///	書き込み先のデータのオフセット。
+		///	@param	bitdepth
+		///	各ピクセルのデータ長。
+		///	@param	size
+		///	画像の大きさ。
+		///	@param	batchrows
+		///	1回の書き込みでまとめる水平ラインの数。
+		///	@exception	std::invalid_argument
+		///	@a batchrows に0が指定されました。
+		DIBCoreBitmapEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size, size_t batchrows = 1U);
+		///	書き込まれていないデータを書き込み、オブジェクトを破棄します。
+		///	書き込み中に発生した例外は無視されます。
+		virtual ~DIBCoreBitmapEncoder();
 
 		///	現在の位置にオブジェクトを書き込み、現在の位置を次に進めます。
+		///	@note
+		///	データはバッファに格納され、 @a batchrows 分の水平ラインが揃うか画像の末尾に達した時点でパディングを含めて1回で書き込まれます。
 		void Write(const ValueType& value);
+		///	現在の位置から1水平ライン分の色を書き込み、現在の位置を次の水平ラインの先頭に進めます。
+		///	@param	row
+		///	書き込む色。
+		///	画像の幅の長さの領域が確保されている必要があります。
+		///	水平ラインはファイル上の並び順(画像の下から上)で書き込まれるため、 @a CurrentPos().Y() の水平ラインの色を渡す必要があります。
+		///	@param	packer
+		///	色をピクセルデータに変換する @a DIBRowConverter 。
+		///	@exception	InvalidOperationException
+		///	現在の位置が水平ラインの先頭ではありません。
+		///	@exception	std::invalid_argument
+		///	@a packer の各ピクセルのデータ長がこのオブジェクトと一致しません。
+		void WriteRow(const RGB8_t* row, const DIBRowConverter& packer);
+		///	バッファに格納されているデータを書き込みます。
+		///	書き込み途中の水平ラインはストライド全体が書き込まれ、未書き込みのピクセルは0になります。
+		void Flush();
 		///	現在の位置を初期位置に戻します。
+		///	バッファに格納されているデータは先に書き込まれます。
 		void Reset();
 		///	現在の位置が値を持っているかを取得します。
 		[[nodiscard]] bool HasValue() const;
@@ -126,6 +276,7 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] int Compare(const DIBCoreBitmapEncoder& other) const;
 
 		[[nodiscard]] static size_t GetPxLength(DIBBitDepth bitdepth);
+		[[nodiscard]] static size_t GetRowLength(DIBBitDepth bitdepth, const DisplayRectSize& size);
 		[[nodiscard]] static size_t GetStrideLength(DIBBitDepth bitdepth, const DisplayRectSize& size);
 		[[nodiscard]] static size_t GetImageLength(DIBBitDepth bitdepth, const DisplayRectSize& size);
 	private:
@@ -140,10 +291,18 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		typedef uint32_t RawDataType;
 		typedef RGB8_t ValueType;
 		typedef RGB8Pixmap_t Pixmap;
+		typedef DIBCoreBitmapDecoder DecoderType;
+		typedef DIBPixelCursor<DIBCoreBitmap> PixelCursor;
+		typedef DIBImageView<DIBCoreBitmap> ImageView;
+		friend class DIBPixelCursor<DIBCoreBitmap>;
+		friend class DIBImageView<DIBCoreBitmap>;
 	private:
 		DIBLoader&& loader;
 		DIBCoreHeader ihead;
 		std::vector<RGB8_t> palette;
+		DIBRowConverter converter;
+		size_t concurrency;
+		DIBTileCache tilecache;
 	public:
 		///	@a DIBFileLoader を使用して @a DIBCoreBitmap を初期化します。
 		///	@param	loader
@@ -158,7 +317,48 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] const DIBCoreHeader& InfoHead() const { return ihead; }
 		///	このオブジェクトの色パレットを取得します。
 		[[nodiscard]] std::optional<std::reference_wrapper<const std::vector<RGB8_t>>> Palette() const;
+		///	@a CopyTo および @a ToPixmap で使用するスレッド数を取得します。
+		[[nodiscard]] size_t DecodeConcurrency() const { return concurrency; }
+		///	@a CopyTo および @a ToPixmap で使用するスレッド数を設定します。
+		///	@param	threads
+		///	使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	既定値は 1 (呼び出し元のスレッドのみ)です。
+		///	@note
+		///	帯への分割と、呼び出し元のスレッドのみでデコードされる条件は @a DIBBandDecodeHelper::Decode を参照してください。
+		///	コピー先の画像バッファには異なる位置への書き込みが並行して行われます。
+		void SetDecodeConcurrency(size_t threads) { concurrency = threads; }
+		///	タイルのキャッシュの統計情報を取得します。
+		[[nodiscard]] const DIBTileCacheStatistics& TileCacheStatistics() const { return tilecache.Statistics(); }
+		///	デコードされたタイルのキャッシュの構成を変更します。
+		///	キャッシュされているタイルおよび統計情報は破棄されます。
+		///	@param	capacity
+		///	保持するタイルの合計の最大バイト数。 0 を指定した場合、キャッシュは無効になります。
+		///	既定ではキャッシュは無効です。
+		///	@param	tilesize
+		///	タイルの一辺の長さ(ピクセル単位)。
+		///	@note
+		///	キャッシュが有効な場合、 @a GetPixel(const DisplayPoint&) 、 @a CopyTo(WritableImage<RGB8_t>&, const DisplayRectangle&, const DisplayPoint&) および @a ToPixmap(const DisplayRectangle&) はキャッシュされたタイルから色を取得します。
+		///	このオブジェクトを経由した書き込みでは、書き込んだ位置を含むタイルが破棄されます。
+		void SetTileCache(size_t capacity, int32_t tilesize = DIBTileCache::DefaultTileSize);
+		///	キャッシュされているタイルを破棄します。
+		///	@a DIBLoader を直接使用してピクセル配列を書き換えた場合に使用します。
+		void ClearTileCache() noexcept { tilecache.Clear(); }
+		///	タイルのキャッシュの統計情報をリセットします。
+		void ResetTileCacheStatistics() noexcept { tilecache.ResetStatistics(); }
 
+		///	画像の任意の位置のピクセルを繰り返し読み書きするための @a PixelCursor を取得します。
+		///	@note
+		///	@a PixelCursor は画像の情報を保持し、ピクセルデータは要求された時点でのみ読み込みます。
+		///	多数の位置を参照する場合は、 @a GetPixel を繰り返し呼び出す代わりに1つの @a PixelCursor を使い回してください。
+		[[nodiscard]] PixelCursor Cursor();
+		///	このビットマップを @a Image<RGB8_t> として参照する @a ImageView を取得します。
+		///	@param	rowcount
+		///	@a ImageView が保持する水平ラインの数。
+		///	@note
+		///	@a ImageView は要求された水平ラインのみをデコードするため、 @a ToPixmap で画像全体を展開せずに画像を受け取る処理へ渡すことができます。
+		///	このビットマップへの書き込みは、 @a ImageView が保持している水平ラインには反映されません。
+		///	@a ImageView を @a Generate や @a DIBScanlineWriter::WriteImage に渡す場合、スレッド数には1を指定する必要があります。
+		[[nodiscard]] ImageView View(int32_t rowcount = ImageView::DefaultRowCount);
 		///	画像の指定された位置にある1ピクセルの色を取得します。
 		///	@param	pos
 		///	取得する画像上の座標位置。
@@ -223,9 +423,41 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	画像の切り抜き範囲。
 		[[nodiscard]] Pixmap ToPixmap(const DisplayRectangle& area);
 
-		static std::optional<DIBCoreBitmap> Generate(DIBLoader&& loader, const DIBCoreHeader& header, const Image<RGB8_t>& image);
-		static std::optional<DIBCoreBitmap> Generate(DIBLoader&& loader, const DIBCoreHeader& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image);
+		///	指定された @a DIBLoader に画像データを書き込み、 @a DIBCoreBitmap を生成します。
+		///	@param	loader
+		///	書き込み先の @a DIBLoader オブジェクト。
+		///	このオブジェクトで「消費」されるため、右辺値参照である必要があります。
+		///	@param	header
+		///	生成時に格納する画像ヘッダデータ。
+		///	@param	image
+		///	生成時に格納する画像データ。
+		///	@param	concurrency
+		///	画像データの変換に使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@return
+		///	書き込んだデータを参照する @a DIBCoreBitmap 。
+		///	@a loader が読み込みに対応していない場合( @a DIBOutputStreamLoader など)は、書き込みのみを行い @a std::nullopt を返します。
+		///	書き込んだデータをビットマップとして読み込めなかった場合も @a std::nullopt を返します。
+		static std::optional<DIBCoreBitmap> Generate(DIBLoader&& loader, const DIBCoreHeader& header, const Image<RGB8_t>& image, size_t concurrency = 1);
+		///	指定された @a DIBLoader に画像データを書き込み、 @a DIBCoreBitmap を生成します。
+		///	@param	loader
+		///	書き込み先の @a DIBLoader オブジェクト。
+		///	このオブジェクトで「消費」されるため、右辺値参照である必要があります。
+		///	@param	header
+		///	生成時に格納する画像ヘッダデータ。
+		///	@param	palette
+		///	生成時に格納する色パレット。
+		///	@param	image
+		///	生成時に格納する画像データ。
+		///	@param	concurrency
+		///	画像データの変換に使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@return
+		///	書き込んだデータを参照する @a DIBCoreBitmap 。
+		///	@a loader が読み込みに対応していない場合( @a DIBOutputStreamLoader など)は、書き込みのみを行い @a std::nullopt を返します。
+		///	書き込んだデータをビットマップとして読み込めなかった場合も @a std::nullopt を返します。
+		static std::optional<DIBCoreBitmap> Generate(DIBLoader&& loader, const DIBCoreHeader& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image, size_t concurrency = 1);
 	private:
+		void DecodeRegion(const DisplayRectangle& area, RGB8_t* dest);
+		void InvalidateTiles(const DisplayRectangle& area) noexcept { tilecache.Invalidate(area); }
 		[[nodiscard]] ValueType ConvertToRGB(const DIBCoreBitmapDecoder::ValueType& data) const;
 		[[nodiscard]] RawDataType ConvertToRawData(const DIBCoreBitmapDecoder::ValueType& data) const;
 		[[nodiscard]] DIBCoreBitmapDecoder::ValueType ConvertToDecoderValue(const ValueType& value) const;
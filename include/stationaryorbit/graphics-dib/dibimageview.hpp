@@ -0,0 +1,109 @@
+//	stationaryorbit/graphics-dib/dibimageview
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibimageview__
+#define __stationaryorbit_graphics_dib_dibimageview__
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <mutex>
+#include "stationaryorbit/graphics-core.image.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	@a DIBImageView の共通の基底クラスです。
+	///	書き込み元の画像がビューであるかの判定に使用されます。
+	class DIBImageViewBase : public Image<RGB8_t> {};
+	///	ビットマップを @a Image<RGB8_t> として参照するためのビューです。
+	///	@param	Bitmap
+	///	ビューを取得したビットマップの型。
+	///	@note
+	///	ピクセルは要求された時点で水平ライン単位でデコードされ、直近の数本の水平ラインのみを保持します。
+	///	画像全体を @a ToPixmap で展開せずに、画像を受け取る処理へ直接渡すことができます。
+	///	水平ラインを跨いで縦方向に走査する処理では、ピクセルごとにデコードが発生する場合があります。
+	///	保持している水平ラインの参照と更新は排他的に行われるため、複数のスレッドから同時に @a At を呼び出すことができます。
+	///	ただし、スレッドごとに異なる水平ラインを参照すると水平ラインのデコードが繰り返されるため、
+	///	複数のスレッドで画像を変換する書き込み( @a DIBBandEncodeHelper::Encode )にビューを渡すことはできません。
+	///	ビューは取得元のビットマップを参照するため、ビットマップより長く生存してはいけません。
+	template<class Bitmap>
+	class DIBImageView final : public DIBImageViewBase
+	{
+	public:
+		///	既定の保持する水平ラインの数。
+		static constexpr int32_t DefaultRowCount = 4;
+	private:
+		Bitmap& bitmap;
+		DisplayRectangle area;
+		int32_t rowcount;
+		///	保持している水平ラインの先頭のY座標。
+		mutable int32_t top;
+		///	保持している水平ラインの数。
+		mutable int32_t count;
+		///	保持している水平ラインの色。画像上の並び順で格納されます。
+		mutable std::vector<RGB8_t> rows;
+		///	保持している水平ラインの参照と更新の排他制御に使用するミューテックス。
+		mutable std::mutex lock;
+	public:
+		///	@a DIBImageView を初期化します。
+		///	@param	bitmap
+		///	参照するビットマップ。
+		///	@param	size
+		///	画像の大きさ。
+		///	@param	rowcount
+		///	保持する水平ラインの数。
+		///	@exception	std::invalid_argument
+		///	@a rowcount に0以下の値が指定されました。
+		DIBImageView(Bitmap& bitmap, const DisplayRectSize& size, int32_t rowcount = DefaultRowCount)
+			: bitmap(bitmap), area(DisplayPoint(0, 0), size), rowcount(rowcount), top(0), count(0), rows(), lock()
+		{
+			if (rowcount <= 0) { throw std::invalid_argument("rowcountに0以下の値を指定することはできません。"); }
+		}
+
+		///	画像の領域を取得します。
+		[[nodiscard]] const DisplayRectangle& Area() const override { return area; }
+		///	指定された位置のピクセルの色を取得します。
+		///	@exception	std::out_of_range
+		///	指定された座標はこの画像領域を超えています。
+		[[nodiscard]] ValueType At(const DisplayPoint& pos) const override
+		{
+			if ( (pos.X() < 0)||(pos.Y() < 0)||(area.Width() <= pos.X())||(area.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
+			auto guard = std::lock_guard<std::mutex>(lock);
+			if ( (pos.Y() < top)||((top + count) <= pos.Y()) ) { Fetch(pos.Y()); }
+			return rows[(size_t(pos.Y() - top) * area.Width()) + pos.X()];
+		}
+		///	保持している水平ラインを破棄します。
+		///	ビットマップへ書き込みを行った場合に使用します。
+		void Invalidate()
+		{
+			auto guard = std::lock_guard<std::mutex>(lock);
+			count = 0;
+		}
+	private:
+		void Fetch(int32_t y) const
+		{
+			//	上方向に走査している場合は、要求された水平ラインが末尾になるように読み込む
+			auto first = (y < top)?(std::max(0, y - rowcount + 1)):(y);
+			auto last = std::min(area.Height(), first + rowcount);
+			rows.resize(size_t(area.Width()) * (last - first));
+			count = 0;
+			bitmap.DecodeRegion(DisplayRectangle(0, first, area.Width(), last - first), rows.data());
+			top = first;
+			count = last - first;
+		}
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibimageview__
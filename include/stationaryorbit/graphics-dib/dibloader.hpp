@@ -21,12 +21,26 @@
 #include <vector>
 #include <variant>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <list>
+#include <unordered_map>
 #include "stationaryorbit/graphics-core.image.hpp"
 #include "dibpixeldata.hpp"
 #include "dibheaders.hpp"
 #include "invaliddibformat.hpp"
 namespace zawa_ch::StationaryOrbit::Graphics::DIB
 {
+	///	@a DIBLoader::WriteV で書き込む1つの領域を表します。
+	struct DIBWriteSegment final
+	{
+		///	書き込むデータの格納先。 @a Length の長さの領域が確保されている必要があります。
+		const char* Source;
+		///	書き込むデータの位置。
+		size_t Position;
+		///	書き込むデータの長さ。
+		size_t Length;
+	};
 	///	ストリームから Windows bitmap 画像を読み込むための基本ロジックを実装します。
 	class DIBLoader
 	{
@@ -42,6 +56,10 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] virtual const DIBFileHeader& FileHead() const = 0;
 		///	このオブジェクトの読み込まれた情報ヘッダのサイズを取得します。
 		[[nodiscard]] virtual const int32_t& HeaderSize() const = 0;
+		///	このオブジェクトに書き込んだデータを読み込むことができるかを取得します。
+		///	@note
+		///	既定の実装は @a true を返します。書き込み専用の派生クラスは @a false を返します。
+		[[nodiscard]] virtual bool IsReadable() const { return true; }
 
 		///	ストリームおよび内部の状態を紐付けられたストレージと同期します。
 		virtual void Sync() noexcept = 0;
@@ -54,6 +72,16 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	@param	size
 		///	読み込むデータの個数。
 		virtual void Read(char* dest, size_t pos, size_t size = 1U) = 0;
+		///	ストリームの指定した範囲のデータを複製せずに参照します。
+		///	@param	pos
+		///	参照するデータの位置。
+		///	@param	size
+		///	参照するデータの長さ。
+		///	@return
+		///	範囲全体がメモリ上で直接参照できる場合はその先頭を返します。それ以外の場合は @a nullptr を返し、呼び出し元は @a Read を使用します。
+		///	@note
+		///	返された領域は、このオブジェクトへの次の書き込みまたは @a Sync の呼び出しまで有効です。
+		[[nodiscard]] virtual const char* Peek(size_t pos, size_t size) { return nullptr; }
 		///	ストリームの指定した位置からデータの書き込みを行います。
 		///	@param	source
 		///	書き込むデータの格納先。
@@ -63,14 +91,58 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	@param	size
 		///	書き込むデータの個数。
 		virtual void Write(const char* source, size_t pos, size_t size = 1U) = 0;
+		///	複数の領域の書き込みをまとめて行います。
+		///	@param	segments
+		///	書き込む領域。先頭から順に書き込まれ、長さが0の領域は無視されます。
+		///	@note
+		///	既定の実装は領域ごとに @a Write を呼び出します。
+		///	派生クラスは位置が連続する領域を1回の書き込みにまとめることができます。
+		virtual void WriteV(const std::vector<DIBWriteSegment>& segments) { for (const auto& segment: segments) { if (0 < segment.Length) { Write(segment.Source, segment.Position, segment.Length); } } }
+		///	このオブジェクトと同じデータを参照する、読み込み専用の @a DIBLoader を構築します。
+		///	@return
+		///	構築されたオブジェクトは読み込み位置やキャッシュをこのオブジェクトと共有しないため、他のスレッドで使用することができます。
+		///	独立した読み込みをサポートしない場合は @a nullptr を返します。
+		///	@note
+		///	構築されたオブジェクトを使用している間、このオブジェクトへの書き込みを行ってはいけません。
+		[[nodiscard]] virtual std::unique_ptr<DIBLoader> CreateReader() { return nullptr; }
+	};
+	///	@a DIBLoader の読み込みキャッシュの統計情報。
+	struct DIBLoaderCacheStatistics final
+	{
+		///	キャッシュから読み込みを行った回数。
+		size_t Hit;
+		///	ストレージからブロックを読み込んだ回数。
+		size_t Miss;
+
+		///	キャッシュのヒット率を取得します。
+		[[nodiscard]] constexpr double HitRatio() const { return ((Hit + Miss) != 0)?(double(Hit) / double(Hit + Miss)):(0.0); }
 	};
 	///	Windows bitmap 画像ファイルを読み込むための基本ロジックを提供します。
+	///	@note
+	///	ブロック長に整列したブロック単位の読み込みキャッシュを持ちます。
+	///	書き込みはストリームに直接反映され、重なるブロックはキャッシュから破棄されます。
 	class DIBFileLoader : public DIBLoader
 	{
+	public:
+		///	既定のキャッシュのブロック長(バイト単位)。
+		static constexpr size_t DefaultCacheBlockSize = 65536U;
+		///	既定のキャッシュのブロック数。
+		static constexpr size_t DefaultCacheBlockCount = 16U;
 	private:
+		struct CacheBlock
+		{
+			size_t index;
+			std::vector<char> data;
+		};
 		std::fstream stream;
+		std::string filename;
 		DIBFileHeader fhead;
 		int32_t headersize;
+		size_t blocksize;
+		size_t blockcount;
+		std::list<CacheBlock> cache;
+		std::unordered_map<size_t, std::list<CacheBlock>::iterator> cacheindex;
+		DIBLoaderCacheStatistics statistics;
 	public:
 		///	@a DIBFileLoader をデフォルト構築します。
 		DIBFileLoader();
@@ -103,7 +175,24 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] const DIBFileHeader& FileHead() const { return fhead; }
 		///	このオブジェクトの読み込まれた情報ヘッダのサイズを取得します。
 		[[nodiscard]] const int32_t& HeaderSize() const { return headersize; }
+		///	読み込みキャッシュのブロック長を取得します。
+		[[nodiscard]] size_t CacheBlockSize() const { return blocksize; }
+		///	読み込みキャッシュの最大ブロック数を取得します。
+		[[nodiscard]] size_t CacheBlockCount() const { return blockcount; }
+		///	読み込みキャッシュの統計情報を取得します。
+		[[nodiscard]] const DIBLoaderCacheStatistics& CacheStatistics() const { return statistics; }
 
+		///	読み込みキャッシュの構成を変更します。
+		///	キャッシュされているブロックは破棄されます。
+		///	@param	blocksize
+		///	1ブロックの長さ(バイト単位)。
+		///	@param	blockcount
+		///	保持する最大のブロック数。 0 を指定した場合、キャッシュは無効になります。
+		void SetCache(size_t blocksize, size_t blockcount);
+		///	キャッシュされているブロックを破棄します。
+		void ClearCache() noexcept;
+		///	読み込みキャッシュの統計情報をリセットします。
+		void ResetCacheStatistics() noexcept;
 		///	ストリームおよび内部の状態を紐付けられたストレージと同期します。
 		void Sync() noexcept;
 		///	データの読み込みを行います。
@@ -124,10 +213,426 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	@param	size
 		///	書き込むデータの個数。
 		void Write(const char* source, size_t pos, size_t length = 1U);
+		///	複数の領域の書き込みをまとめて行います。
+		///	書き込む前に出力バッファを書き出し、領域に重なるブロックをキャッシュから破棄します。
+		///	位置が連続する領域は1回のシークに続けて書き込まれます。
+		///	@param	segments
+		///	書き込む領域。先頭から順に書き込まれ、長さが0の領域は無視されます。
+		void WriteV(const std::vector<DIBWriteSegment>& segments);
+		///	同じファイルを読み込み専用で開き直した @a DIBFileLoader を構築します。
+		///	ファイル名を指定せずに構築されたオブジェクトでは @a nullptr を返します。
+		[[nodiscard]] std::unique_ptr<DIBLoader> CreateReader();
 
 	private:
 		void LoadHead() noexcept;
 		void Flush() noexcept;
+		void ReadStream(char* dest, size_t pos, size_t length);
+		const CacheBlock& FetchBlock(size_t index);
+		void InvalidateBlocks(size_t pos, size_t length) noexcept;
+	};
+	///	Windows bitmap 画像ファイルをメモリにマップして読み込むための基本ロジックを提供します。
+	///	@note
+	///	ファイル全体をマップするため、 @a Write でファイルの長さを超える書き込みを行うことはできません。
+	class DIBMappedFileLoader : public DIBLoader
+	{
+	private:
+		int fd;
+		char* data;
+		size_t length;
+		bool writable;
+		DIBFileHeader fhead;
+		int32_t headersize;
+	public:
+		///	@a DIBMappedFileLoader をデフォルト構築します。
+		DIBMappedFileLoader();
+		///	指定したファイル名のファイルをマップし、 @a DIBMappedFileLoader を初期化します。
+		///	@param	filename
+		///	開くファイルの名前。
+		///	@param	mode
+		///	ファイルを開くモード。 @a std::ios_base::out が含まれる場合は書き込み可能な状態でマップされます。
+		DIBMappedFileLoader(const char* filename, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary);
+		///	指定したファイル名のファイルをマップし、 @a DIBMappedFileLoader を初期化します。
+		///	@param	filename
+		///	開くファイルの名前。
+		///	@param	mode
+		///	ファイルを開くモード。 @a std::ios_base::out が含まれる場合は書き込み可能な状態でマップされます。
+		DIBMappedFileLoader(const std::string& filename, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary);
+		DIBMappedFileLoader(const DIBMappedFileLoader&) = delete;
+		DIBMappedFileLoader(DIBMappedFileLoader&& other) noexcept;
+		virtual ~DIBMappedFileLoader();
+
+		///	このオブジェクトが Windos bitmap 画像としての読み込みが可能な状態であるかを取得します。
+		[[nodiscard]] bool IsEnable() const;
+		///	このオブジェクトはストリームを持たないため、常に @a InvalidOperationException をスローします。
+		[[nodiscard]] std::iostream& Stream();
+		///	このオブジェクトの読み込まれたファイルヘッダを取得します。
+		[[nodiscard]] const DIBFileHeader& FileHead() const { return fhead; }
+		///	このオブジェクトの読み込まれた情報ヘッダのサイズを取得します。
+		[[nodiscard]] const int32_t& HeaderSize() const { return headersize; }
+		///	マップされたファイル全体の先頭を取得します。
+		[[nodiscard]] const char* Data() const { return data; }
+		///	マップされたファイル全体の長さを取得します。
+		[[nodiscard]] size_t Length() const { return length; }
+		///	このオブジェクトが書き込み可能な状態でマップされているかを取得します。
+		[[nodiscard]] bool IsWritable() const { return writable; }
+		///	マップされたピクセル配列の先頭を取得します。
+		///	@note
+		///	デコーダーは @a Peek を通じてこの領域から直接変換を行います。
+		[[nodiscard]] const char* PixelData() const;
+		///	マップされたピクセル配列の先頭を書き込み可能な状態で取得します。
+		///	@exception	InvalidOperationException
+		///	このオブジェクトが読み込み専用でマップされています。
+		[[nodiscard]] char* WritablePixelData();
+		///	マップされたピクセル配列の長さを取得します。
+		[[nodiscard]] size_t PixelDataLength() const;
+
+		///	マップされた領域を紐付けられたファイルと同期し、ヘッダを再読み込みします。
+		void Sync() noexcept;
+		///	データの読み込みを行います。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	読み込むデータの位置。
+		///	@param	size
+		///	読み込むデータの個数。
+		void Read(char* dest, size_t pos, size_t length = 1U);
+		///	マップされた領域を複製せずに参照します。
+		///	@param	pos
+		///	参照するデータの位置。
+		///	@param	size
+		///	参照するデータの長さ。
+		///	@return
+		///	範囲がマップされた領域を超える場合は @a nullptr を返します。
+		[[nodiscard]] const char* Peek(size_t pos, size_t length);
+		///	データの書き込みを行います。
+		///	@param	source
+		///	書き込むデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	書き込むデータの位置。
+		///	@param	size
+		///	書き込むデータの個数。
+		void Write(const char* source, size_t pos, size_t length = 1U);
+		///	複数の領域の書き込みをまとめて行います。
+		///	すべての領域の範囲を確認してから書き込むため、例外がスローされた場合はいずれの領域も書き込まれません。
+		///	@param	segments
+		///	書き込む領域。先頭から順に書き込まれ、長さが0の領域は無視されます。
+		///	@exception	std::out_of_range
+		///	書き込み先の位置がマップされた領域を超えています。
+		void WriteV(const std::vector<DIBWriteSegment>& segments);
+		///	マップされた領域を参照する読み込み専用の @a DIBMemoryLoader を構築します。
+		[[nodiscard]] std::unique_ptr<DIBLoader> CreateReader();
+
+	private:
+		void LoadHead() noexcept;
+		void Unmap() noexcept;
+	};
+	///	ファイル記述子に対する位置指定の入出力( @a pread / @a pwrite )で Windows bitmap 画像ファイルを読み込むための基本ロジックを提供します。
+	///	@note
+	///	読み込み位置を共有せず、内部の状態も変更しないため、複数のスレッドから同時に @a Read を呼び出すことができます。
+	///	書き込みはファイルに直接反映されます。 @a Write と @a Read を並行して行う場合、重なる範囲の内容は保証されません。
+	class DIBPositionalFileLoader : public DIBLoader
+	{
+	private:
+		int fd;
+		bool writable;
+		DIBFileHeader fhead;
+		int32_t headersize;
+	public:
+		///	@a DIBPositionalFileLoader をデフォルト構築します。
+		DIBPositionalFileLoader();
+		///	指定したファイル名のファイルを開き、 @a DIBPositionalFileLoader を初期化します。
+		///	@param	filename
+		///	開くファイルの名前。
+		///	@param	mode
+		///	ファイルを開くモード。
+		///	@a std::ios_base::out が含まれる場合は書き込み可能な状態で開かれます。
+		///	さらに @a std::ios_base::in が含まれないか @a std::ios_base::trunc が含まれる場合、ファイルは作成または切り詰められます。
+		DIBPositionalFileLoader(const char* filename, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary);
+		///	指定したファイル名のファイルを開き、 @a DIBPositionalFileLoader を初期化します。
+		///	@param	filename
+		///	開くファイルの名前。
+		///	@param	mode
+		///	ファイルを開くモード。
+		DIBPositionalFileLoader(const std::string& filename, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary);
+		DIBPositionalFileLoader(const DIBPositionalFileLoader&) = delete;
+		DIBPositionalFileLoader(DIBPositionalFileLoader&& other) noexcept;
+		virtual ~DIBPositionalFileLoader();
+
+		///	このオブジェクトが Windos bitmap 画像としての読み込みが可能な状態であるかを取得します。
+		[[nodiscard]] bool IsEnable() const;
+		///	このオブジェクトはストリームを持たないため、常に @a InvalidOperationException をスローします。
+		[[nodiscard]] std::iostream& Stream();
+		///	このオブジェクトの読み込まれたファイルヘッダを取得します。
+		[[nodiscard]] const DIBFileHeader& FileHead() const { return fhead; }
+		///	このオブジェクトの読み込まれた情報ヘッダのサイズを取得します。
+		[[nodiscard]] const int32_t& HeaderSize() const { return headersize; }
+		///	このオブジェクトが書き込み可能な状態で開かれているかを取得します。
+		[[nodiscard]] bool IsWritable() const { return writable; }
+
+		///	ヘッダを再読み込みします。
+		void Sync() noexcept;
+		///	データの読み込みを行います。
+		///	このメンバ関数は複数のスレッドから同時に呼び出すことができます。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	読み込むデータの位置。
+		///	@param	size
+		///	読み込むデータの個数。
+		void Read(char* dest, size_t pos, size_t length = 1U);
+		///	データの書き込みを行います。
+		///	@param	source
+		///	書き込むデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	書き込むデータの位置。
+		///	@param	size
+		///	書き込むデータの個数。
+		///	@exception	InvalidOperationException
+		///	このオブジェクトは読み込み専用で開かれています。
+		void Write(const char* source, size_t pos, size_t length = 1U);
+		///	複数の領域の書き込みをまとめて行います。
+		///	位置が連続する領域は @a pwritev により1回の書き込みで行われます。
+		///	@param	segments
+		///	書き込む領域。
+		///	@exception	InvalidOperationException
+		///	このオブジェクトは読み込み専用で開かれています。
+		void WriteV(const std::vector<DIBWriteSegment>& segments);
+		///	ファイル記述子を複製した、読み込み専用の @a DIBPositionalFileLoader を構築します。
+		[[nodiscard]] std::unique_ptr<DIBLoader> CreateReader();
+
+	private:
+		void LoadHead() noexcept;
+		void Close() noexcept;
+	};
+	///	メモリ上のバイト列から Windows bitmap 画像を読み込むための基本ロジックを提供します。
+	///	@note
+	///	呼び出し元の領域を参照して構築した場合、その領域はこのオブジェクトより長く生存している必要があります。
+	class DIBMemoryLoader : public DIBLoader
+	{
+	private:
+		std::vector<char> buffer;
+		char* external;
+		size_t externallength;
+		bool writable;
+		DIBFileHeader fhead;
+		int32_t headersize;
+	public:
+		///	空のバッファを所有する @a DIBMemoryLoader を構築します。
+		DIBMemoryLoader();
+		///	バッファの所有権を受け取り、 @a DIBMemoryLoader を初期化します。
+		///	@param	buffer
+		///	読み書きに使用するバッファ。
+		///	バッファはこのオブジェクトで「消費」されるため、右辺値参照である必要があります。
+		///	書き込みによりバッファの長さを超えた場合、バッファは拡張されます。
+		DIBMemoryLoader(std::vector<char>&& buffer);
+		///	呼び出し元の書き込み可能な領域を参照する @a DIBMemoryLoader を初期化します。
+		///	@param	data
+		///	参照する領域の先頭。
+		///	@param	length
+		///	参照する領域の長さ。
+		DIBMemoryLoader(char* data, size_t length);
+		///	呼び出し元の読み込み専用の領域を参照する @a DIBMemoryLoader を初期化します。
+		///	@param	data
+		///	参照する領域の先頭。
+		///	@param	length
+		///	参照する領域の長さ。
+		DIBMemoryLoader(const char* data, size_t length);
+		DIBMemoryLoader(const DIBMemoryLoader&) = delete;
+		DIBMemoryLoader(DIBMemoryLoader&&) = default;
+		virtual ~DIBMemoryLoader() = default;
+
+		///	このオブジェクトが Windos bitmap 画像としての読み込みが可能な状態であるかを取得します。
+		[[nodiscard]] bool IsEnable() const;
+		///	このオブジェクトはストリームを持たないため、常に @a InvalidOperationException をスローします。
+		[[nodiscard]] std::iostream& Stream();
+		///	このオブジェクトの読み込まれたファイルヘッダを取得します。
+		[[nodiscard]] const DIBFileHeader& FileHead() const { return fhead; }
+		///	このオブジェクトの読み込まれた情報ヘッダのサイズを取得します。
+		[[nodiscard]] const int32_t& HeaderSize() const { return headersize; }
+		///	データ全体の先頭を取得します。
+		[[nodiscard]] const char* Data() const;
+		///	データ全体の長さを取得します。
+		[[nodiscard]] size_t Length() const;
+		///	このオブジェクトがバッファを所有しているかを取得します。
+		[[nodiscard]] bool IsOwner() const { return external == nullptr; }
+		///	このオブジェクトが所有しているバッファを取得します。
+		///	@exception	InvalidOperationException
+		///	このオブジェクトは呼び出し元の領域を参照しています。
+		[[nodiscard]] const std::vector<char>& Buffer() const;
+
+		///	内部の状態をバッファの内容と同期します。
+		void Sync() noexcept;
+		///	データの読み込みを行います。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	読み込むデータの位置。
+		///	@param	size
+		///	読み込むデータの個数。
+		void Read(char* dest, size_t pos, size_t length = 1U);
+		///	データを複製せずに参照します。
+		///	@param	pos
+		///	参照するデータの位置。
+		///	@param	size
+		///	参照するデータの長さ。
+		///	@return
+		///	範囲がデータの長さを超える場合は @a nullptr を返します。
+		///	所有しているバッファは書き込みにより再確保されることがあるため、書き込みの後は再度取得する必要があります。
+		[[nodiscard]] const char* Peek(size_t pos, size_t length);
+		///	データの書き込みを行います。
+		///	@param	source
+		///	書き込むデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	書き込むデータの位置。
+		///	@param	size
+		///	書き込むデータの個数。
+		void Write(const char* source, size_t pos, size_t length = 1U);
+		///	データを参照する読み込み専用の @a DIBMemoryLoader を構築します。
+		[[nodiscard]] std::unique_ptr<DIBLoader> CreateReader();
+
+	private:
+		void LoadHead() noexcept;
+	};
+	///	シークできない入力ストリームから Windows bitmap 画像を先頭から順に読み込むための基本ロジックを提供します。
+	///	@note
+	///	標準入力やパイプ・ソケットなど、読み込んだデータに戻ることができない入力から画像を読み込むために使用します。
+	///	読み込みはストリーム上で前方の位置に対してのみ行うことができ、間にあるデータは読み捨てられます。
+	///	ただし、構築時に読み込まれるファイルヘッダと情報ヘッダのサイズの範囲は何度でも読み込むことができます。
+	///	@a DIBScanlineReader はこの順序で読み込みを行うため、このオブジェクトと組み合わせて使用することができます。
+	///	このオブジェクトは参照しているストリームやファイル記述子を閉じません。
+	class DIBStreamLoader : public DIBLoader
+	{
+	private:
+		std::istream* stream;
+		int fd;
+		DIBFileHeader fhead;
+		int32_t headersize;
+		///	これまでに入力から読み込んだバイト数。
+		size_t position;
+	public:
+		///	入力ストリームを参照する @a DIBStreamLoader を初期化し、ファイルヘッダを読み込みます。
+		///	@param	stream
+		///	読み込みに使用する @a std::istream 。
+		///	ストリームはこのオブジェクトより長く生存している必要があります。
+		DIBStreamLoader(std::istream& stream);
+		///	ファイル記述子を参照する @a DIBStreamLoader を初期化し、ファイルヘッダを読み込みます。
+		///	@param	fd
+		///	読み込みに使用するファイル記述子。
+		DIBStreamLoader(int fd);
+		DIBStreamLoader(const DIBStreamLoader&) = delete;
+		DIBStreamLoader(DIBStreamLoader&&) = default;
+		virtual ~DIBStreamLoader() = default;
+
+		///	このオブジェクトが Windos bitmap 画像としての読み込みが可能な状態であるかを取得します。
+		[[nodiscard]] bool IsEnable() const;
+		///	このオブジェクトは入出力両用のストリームを持たないため、常に @a InvalidOperationException をスローします。
+		[[nodiscard]] std::iostream& Stream();
+		///	このオブジェクトの読み込まれたファイルヘッダを取得します。
+		[[nodiscard]] const DIBFileHeader& FileHead() const { return fhead; }
+		///	このオブジェクトの読み込まれた情報ヘッダのサイズを取得します。
+		[[nodiscard]] const int32_t& HeaderSize() const { return headersize; }
+		///	これまでに入力から読み込んだバイト数を取得します。
+		[[nodiscard]] size_t Position() const { return position; }
+
+		///	入力は巻き戻すことができないため、何もしません。
+		void Sync() noexcept;
+		///	データの読み込みを行います。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	読み込むデータの位置。
+		///	ファイルヘッダと情報ヘッダのサイズの範囲を除き、 @a Position() 以降の位置である必要があります。
+		///	@param	size
+		///	読み込むデータの個数。
+		///	@exception	InvalidOperationException
+		///	すでに読み込み済みの位置が指定されました。
+		///	@exception	InvalidDIBFormatException
+		///	データの読み取り中に入力の終端に到達しました。
+		void Read(char* dest, size_t pos, size_t length = 1U);
+		///	このオブジェクトは読み込み専用であるため、常に @a InvalidOperationException をスローします。
+		void Write(const char* source, size_t pos, size_t length = 1U);
+
+	private:
+		void LoadHead() noexcept;
+		///	入力から指定された長さのデータを読み込み、読み込んだバイト数を返します。
+		size_t ReadSource(char* dest, size_t length);
+		void Skip(size_t length);
+	};
+	///	シークできない出力ストリームへ Windows bitmap 画像を先頭から順に書き込むための基本ロジックを提供します。
+	///	@note
+	///	標準出力やパイプ・ソケットなど、書き込んだデータに戻ることができない出力へ画像を書き込むために使用します。
+	///	書き込みはストリーム上で前方の位置に対してのみ行うことができ、間の領域は0で埋められます。
+	///	@a DIBScanlineWriter はヘッダを構築時に確定し、この順序で書き込みを行うため、このオブジェクトと組み合わせて使用することができます。
+	///	このオブジェクトは参照しているストリームやファイル記述子を閉じません。
+	class DIBOutputStreamLoader : public DIBLoader
+	{
+	private:
+		std::ostream* stream;
+		int fd;
+		DIBFileHeader fhead;
+		int32_t headersize;
+		///	これまでに出力へ書き込んだバイト数。
+		size_t position;
+	public:
+		///	出力ストリームを参照する @a DIBOutputStreamLoader を初期化します。
+		///	@param	stream
+		///	書き込みに使用する @a std::ostream 。
+		///	ストリームはこのオブジェクトより長く生存している必要があります。
+		DIBOutputStreamLoader(std::ostream& stream);
+		///	ファイル記述子を参照する @a DIBOutputStreamLoader を初期化します。
+		///	@param	fd
+		///	書き込みに使用するファイル記述子。
+		DIBOutputStreamLoader(int fd);
+		DIBOutputStreamLoader(const DIBOutputStreamLoader&) = delete;
+		DIBOutputStreamLoader(DIBOutputStreamLoader&&) = default;
+		virtual ~DIBOutputStreamLoader() = default;
+
+		///	このオブジェクトにファイルヘッダが書き込まれているかを取得します。
+		[[nodiscard]] bool IsEnable() const;
+		///	このオブジェクトは入出力両用のストリームを持たないため、常に @a InvalidOperationException をスローします。
+		[[nodiscard]] std::iostream& Stream();
+		///	このオブジェクトに書き込まれたファイルヘッダを取得します。
+		[[nodiscard]] const DIBFileHeader& FileHead() const { return fhead; }
+		///	このオブジェクトに書き込まれた情報ヘッダのサイズを取得します。
+		[[nodiscard]] const int32_t& HeaderSize() const { return headersize; }
+		///	これまでに出力へ書き込んだバイト数を取得します。
+		[[nodiscard]] size_t Position() const { return position; }
+		///	出力は読み込むことができないため、常に @a false を返します。
+		[[nodiscard]] bool IsReadable() const { return false; }
+
+		///	出力ストリームのバッファを書き出します。
+		void Sync() noexcept;
+		///	出力は読み込むことができないため、常に @a InvalidOperationException をスローします。
+		void Read(char* dest, size_t pos, size_t length = 1U);
+		///	データの書き込みを行います。
+		///	@param	source
+		///	書き込むデータの格納先。
+		///	@a size の長さの領域が確保されている必要があります。
+		///	@param	pos
+		///	書き込むデータの位置。 @a Position() 以降の位置である必要があります。
+		///	@param	size
+		///	書き込むデータの個数。
+		///	@exception	InvalidOperationException
+		///	すでに書き込み済みの位置が指定されました。
+		void Write(const char* source, size_t pos, size_t length = 1U);
+		///	複数の領域の書き込みをまとめて行います。
+		///	ファイル記述子を参照しており、領域が @a Position() から隙間なく続いている場合は @a writev により1回の書き込みで行われます。
+		///	@param	segments
+		///	書き込む領域。
+		///	@exception	InvalidOperationException
+		///	すでに書き込み済みの位置が指定されました。
+		void WriteV(const std::vector<DIBWriteSegment>& segments);
+
+	private:
+		void CaptureHead(const char* source, size_t pos, size_t length) noexcept;
+		void WriteSink(const char* source, size_t length);
 	};
 	///	@a DIBLoader を使用したデータ入出力の拡張を行うヘルパークラスです。
 	class DIBLoaderHelper final
@@ -183,6 +688,28 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	書き込むデータの個数。
 		template<class T>
 		static void Write(DIBLoader& loader, const T& source, const size_t& pos) { loader.Write((const char*)&source, pos, sizeof(T)); }
+		///	指定された型のデータを書き込む @a DIBWriteSegment を構築します。
+		///	@param	T
+		///	書き込むデータの型。
+		///	@param	source
+		///	書き込むデータの格納先。
+		///	@a DIBLoader::WriteV を呼び出すまで有効である必要があります。
+		///	@param	pos
+		///	書き込むデータの位置。
+		///	@param	size
+		///	書き込むデータの個数。
+		template<class T>
+		[[nodiscard]] static DIBWriteSegment Segment(const T* source, const size_t& pos, const size_t& size = 1U) { return DIBWriteSegment{ (const char*)source, pos, sizeof(T) * size }; }
+		///	指定された型のデータを書き込む @a DIBWriteSegment を構築します。
+		///	@param	T
+		///	書き込むデータの型。
+		///	@param	source
+		///	書き込むデータの格納先。
+		///	@a DIBLoader::WriteV を呼び出すまで有効である必要があります。
+		///	@param	pos
+		///	書き込むデータの位置。
+		template<class T>
+		[[nodiscard]] static DIBWriteSegment Segment(const T& source, const size_t& pos) { return DIBWriteSegment{ (const char*)&source, pos, sizeof(T) }; }
 	};
 }
 #endif // __stationaryorbit_graphics_dib_dibloader__
@@ -0,0 +1,169 @@
+//	stationaryorbit/graphics-dib/dibpixelcursor
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibpixelcursor__
+#define __stationaryorbit_graphics_dib_dibpixelcursor__
+#include <vector>
+#include <variant>
+#include <type_traits>
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibtypeddecoder.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	ビットマップ上の任意の位置のピクセルを繰り返し読み書きするためのカーソルです。
+	///	@param	Bitmap
+	///	カーソルを取得したビットマップの型。
+	///	@note
+	///	画像の大きさやストライドなどの情報は構築時に一度だけ求められ、カーソルの移動では読み込みは行われません。
+	///	ピクセルデータは @a Current または @a CurrentRaw で要求された時点で読み込まれます。
+	///	カーソルは取得元のビットマップを参照するため、ビットマップより長く生存してはいけません。
+	template<class Bitmap>
+	class DIBPixelCursor final
+	{
+	public:
+		typedef typename Bitmap::ValueType ValueType;
+		typedef typename Bitmap::RawDataType RawDataType;
+		typedef typename Bitmap::DecoderType DecoderType;
+	private:
+		Bitmap& bitmap;
+		DecoderType decoder;
+	public:
+		DIBPixelCursor(Bitmap& bitmap, DecoderType&& decoder) : bitmap(bitmap), decoder(std::move(decoder)) {}
+
+		///	カーソルを画像の任意の位置に移動します。
+		///	@exception	std::out_of_range
+		///	指定された座標はこの画像領域を超えています。
+		void JumpTo(const DisplayPoint& pos) { decoder.JumpTo(pos); }
+		///	カーソルをファイル上の並び順で次のピクセルに進めます。
+		bool Next() { return decoder.Next(); }
+		///	カーソルをファイル上の並び順で前のピクセルに戻します。
+		bool Previous() { return decoder.Previous(); }
+		///	現在の位置が値を持っているかを取得します。
+		[[nodiscard]] bool HasValue() const { return decoder.HasValue(); }
+		///	現在の位置を画像上での位置で取得します。
+		[[nodiscard]] DisplayPoint CurrentPos() const { return decoder.CurrentPos(); }
+		///	現在の位置にあるピクセルの色を取得します。
+		[[nodiscard]] ValueType Current() const { return bitmap.ConvertToRGB(decoder.Current()); }
+		///	現在の位置にあるピクセルの生データを取得します。
+		[[nodiscard]] RawDataType CurrentRaw() const { return bitmap.ConvertToRawData(decoder.Current()); }
+		///	現在の位置にピクセルの色を書き込みます。
+		void Write(const ValueType& value) { decoder.Write(bitmap.ConvertToDecoderValue(value)); InvalidateCurrent(); }
+		///	現在の位置にピクセルの生データを書き込みます。
+		void WriteRaw(const RawDataType& value) { decoder.Write(bitmap.ConvertToDecoderValue(value)); InvalidateCurrent(); }
+		///	指定された位置に移動し、ピクセルの色を取得します。
+		[[nodiscard]] ValueType Get(const DisplayPoint& pos) { JumpTo(pos); return Current(); }
+		///	指定された位置に移動し、ピクセルの生データを取得します。
+		[[nodiscard]] RawDataType GetRaw(const DisplayPoint& pos) { JumpTo(pos); return CurrentRaw(); }
+		///	指定された位置からファイル上の並び順で連続するピクセルの色を取得します。
+		///	@note
+		///	ビット幅に対応する @a DIBTypedDecoder を1回だけ選択し、水平ラインごとに1回の読み込みで取得します。
+		///	@exception	std::out_of_range
+		///	指定された範囲はこの画像領域を超えています。
+		[[nodiscard]] std::vector<ValueType> Get(const DisplayPoint& pos, size_t count)
+		{
+			auto result = std::vector<ValueType>();
+			result.reserve(count);
+			ReadSpan(pos, count, [&](const auto& pixel) { result.push_back(bitmap.ConvertToRGB(pixel)); });
+			return result;
+		}
+		///	指定された位置からファイル上の並び順で連続するピクセルの生データを取得します。
+		///	@exception	std::out_of_range
+		///	指定された範囲はこの画像領域を超えています。
+		[[nodiscard]] std::vector<RawDataType> GetRaw(const DisplayPoint& pos, size_t count)
+		{
+			auto result = std::vector<RawDataType>();
+			result.reserve(count);
+			ReadSpan(pos, count, [&](const auto& pixel) { result.push_back(RawDataType(pixel)); });
+			return result;
+		}
+		///	指定された位置からファイル上の並び順で連続するピクセルに色を書き込みます。
+		///	@note
+		///	ビット幅に対応する @a DIBTypedDecoder を1回だけ選択し、水平ラインごとに1回の書き込みで格納します。
+		///	@exception	std::out_of_range
+		///	指定された範囲はこの画像領域を超えています。
+		void Write(const DisplayPoint& pos, const std::vector<ValueType>& values)
+		{
+			WriteSpan(pos, values.size(), [&](auto depth, size_t i) { return std::get<DIBPixelData<decltype(depth)::value>>(bitmap.ConvertToDecoderValue(values[i])); });
+		}
+		///	指定された位置からファイル上の並び順で連続するピクセルに生データを書き込みます。
+		///	@exception	std::out_of_range
+		///	指定された範囲はこの画像領域を超えています。
+		void WriteRaw(const DisplayPoint& pos, const std::vector<RawDataType>& values)
+		{
+			WriteSpan(pos, values.size(), [&](auto depth, size_t i) { return DIBPixelData<decltype(depth)::value>(uint32_t(values[i])); });
+		}
+		///	指定された領域がこの画像領域に収まっているかを検証します。
+		///	@exception	std::out_of_range
+		///	指定された領域はこの画像領域を超えています。
+		void ValidateRegion(const DisplayRectangle& area) const { decoder.ValidateRegion(area); }
+		///	範囲の検査を行わずに、指定された位置のピクセルの色を取得します。
+		///	現在の位置は変更されません。
+		///	@note
+		///	@a pos は @a ValidateRegion で検証した領域に含まれている必要があります。
+		[[nodiscard]] ValueType GetUnchecked(const DisplayPoint& pos) const { return bitmap.ConvertToRGB(decoder.GetUnchecked(pos)); }
+	private:
+		///	現在の位置を含む、ビットマップがキャッシュしているタイルを破棄します。
+		void InvalidateCurrent() { bitmap.InvalidateTiles(DisplayRectangle(decoder.CurrentPos(), DisplayRectSize(1, 1))); }
+		template<class T, class V> struct IsAlternative : std::false_type {};
+		template<class T, class... Ts> struct IsAlternative<T, std::variant<Ts...>> : std::disjunction<std::is_same<T, Ts>...> {};
+		///	デコーダーが指定されたビット幅を扱うことができるかを表します。
+		template<DIBBitDepth Depth> static constexpr bool IsSupported = IsAlternative<DIBPixelData<Depth>, typename DecoderType::ValueType>::value;
+
+		template<class F>
+		void ReadSpan(const DisplayPoint& pos, size_t count, F&& sink)
+		{
+			DIBBitDepthDispatcher::Dispatch(decoder.BitDepth(), [&](auto depth)
+			{
+				if constexpr (IsSupported<decltype(depth)::value>)
+				{
+					auto typed = decoder.template Typed<decltype(depth)::value>();
+					auto pixels = std::vector<typename decltype(typed)::ValueType>(count);
+					typed.ReadSpan(pos, count, pixels.data());
+					for (const auto& pixel: pixels) { sink(pixel); }
+				}
+				else { throw InvalidOperationException("このビット幅はサポートされていません。"); }
+			});
+		}
+		template<class F>
+		void WriteSpan(const DisplayPoint& pos, size_t count, F&& source)
+		{
+			DIBBitDepthDispatcher::Dispatch(decoder.BitDepth(), [&](auto depth)
+			{
+				if constexpr (IsSupported<decltype(depth)::value>)
+				{
+					auto typed = decoder.template Typed<decltype(depth)::value>();
+					auto pixels = std::vector<typename decltype(typed)::ValueType>();
+					pixels.reserve(count);
+					for (auto i: Range<size_t>(0, count).GetStdIterator()) { pixels.push_back(source(depth, i)); }
+					typed.WriteSpan(pos, count, pixels.data());
+					if (count != 0)
+					{
+						//	ファイル上の並び順では、水平ラインの末尾の次は1つ上の水平ラインの先頭になる
+						auto width = typed.Size().Width();
+						auto rows = int32_t((size_t(pos.X()) + count + width - 1) / width);
+						bitmap.InvalidateTiles(DisplayRectangle(0, pos.Y() - rows + 1, width, rows));
+					}
+				}
+				else { throw InvalidOperationException("このビット幅はサポートされていません。"); }
+			});
+			//	書き込んだ位置の値を保持している可能性があるため、現在の位置に再度移動して破棄する
+			if (decoder.HasValue()) { decoder.JumpTo(decoder.CurrentPos()); }
+		}
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibpixelcursor__
@@ -74,13 +74,17 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		DIBPixelPerser(DIBPixelPerser&&) = delete;
 		~DIBPixelPerser() = delete;
 	public:
+		///	5ビットの値を上位ビットの複製により8ビットに拡張します。
+		[[nodiscard]] static constexpr uint32_t Expand5(uint32_t value) { return (value << 3) | (value >> 2); }
+		///	6ビットの値を上位ビットの複製により8ビットに拡張します。
+		[[nodiscard]] static constexpr uint32_t Expand6(uint32_t value) { return (value << 2) | (value >> 4); }
 		[[nodiscard]] static constexpr RGB8_t ToRGB(const DIBPixelData<DIBBitDepth::Bit16>& data)
 		{
 			return RGB8_t
 			(
-				Proportion8_t((uint32_t(data) >> 10) & 0x1F, 0x1F),
-				Proportion8_t((uint32_t(data) >> 5) & 0x1F, 0x1F),
-				Proportion8_t(uint32_t(data) & 0x1F, 0x1F)
+				Proportion8_t(Expand5((uint32_t(data) >> 10) & 0x1F), 0xFF),
+				Proportion8_t(Expand5((uint32_t(data) >> 5) & 0x1F), 0xFF),
+				Proportion8_t(Expand5(uint32_t(data) & 0x1F), 0xFF)
 			);
 		}
 		[[nodiscard]] static constexpr RGB8_t ToRGB(const DIBPixelData<DIBBitDepth::Bit24>& data)
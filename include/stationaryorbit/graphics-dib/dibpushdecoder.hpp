@@ -0,0 +1,102 @@
+//	stationaryorbit/graphics-dib/dibpushdecoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibpushdecoder__
+#define __stationaryorbit_graphics_dib_dibpushdecoder__
+#include <vector>
+#include <optional>
+#include <functional>
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibscanlinereader.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	任意の長さに分割して渡されるデータから Windows bitmap 画像を水平ライン単位でデコードします。
+	///	@note
+	///	ヘッダ・色マスク・色パレットは必要な長さのデータが揃った時点で読み込まれ、
+	///	以降は1水平ライン分のデータが揃うごとにデコードして @a RowHandler を呼び出します。
+	///	入力を待つ間スレッドを占有しないため、イベントループ上で受信したデータを順次渡す用途に使用できます。
+	///	メモリ上にはヘッダ・色パレットと、分割された水平ラインの1本分のピクセルデータのみを保持します。
+	///	非圧縮(RGB)およびビットフィールド形式の画像のみをサポートします。
+	class DIBPushDecoder final
+	{
+	public:
+		///	デコードされた水平ラインを受け取る関数。
+		///	@a y は水平ラインの画像上でのY座標、 @a row は画像の横幅の長さの色です。
+		///	@a row は関数の呼び出しの間のみ有効です。
+		typedef std::function<void(int32_t y, const RGB8_t* row)> RowHandler;
+	private:
+		RowHandler handler;
+		///	許容する1水平ラインの長さの上限。
+		size_t maxstridelength;
+		///	ピクセル配列の形式。ヘッダが読み込まれるまでは @a std::nullopt 。
+		std::optional<DIBScanlineFormat> format;
+		///	ヘッダの読み込みのために保持しているデータ。
+		std::vector<char> head;
+		///	分割された水平ラインのピクセルデータ。
+		std::vector<uint8_t> pending;
+		///	デコードした水平ラインの色。
+		std::vector<RGB8_t> row;
+		///	これまでに渡されたデータの長さ。
+		size_t position;
+		///	デコードした水平ラインの数。
+		int32_t decoded;
+		bool failed;
+	public:
+		///	@a DIBPushDecoder を初期化します。
+		///	@param	handler
+		///	デコードされた水平ラインを受け取る関数。
+		///	@param	maxstridelength
+		///	許容するパディングを含む1水平ラインの長さの上限。
+		///	ヘッダの読み込み時にこれを超える画像は無効な形式として扱われます。
+		DIBPushDecoder(const RowHandler& handler, size_t maxstridelength = DIBScanlineFormat::DefaultMaxStrideLength);
+
+		///	ヘッダの読み込みが完了しているかを取得します。
+		[[nodiscard]] bool IsHeaderLoaded() const { return format.has_value(); }
+		///	ピクセル配列の形式を取得します。
+		///	@exception	InvalidOperationException
+		///	ヘッダの読み込みが完了していません。
+		[[nodiscard]] const DIBScanlineFormat& Format() const;
+		///	すべての水平ラインをデコードしたかを取得します。
+		[[nodiscard]] bool IsCompleted() const { return format.has_value()&&(format->Size.Height() <= decoded); }
+		///	これまでにデコードした水平ラインの数を取得します。
+		[[nodiscard]] int32_t RowsDecoded() const { return decoded; }
+		///	これまでに渡されたデータの長さを取得します。
+		[[nodiscard]] size_t Position() const { return position; }
+
+		///	データを渡し、揃った水平ラインをデコードします。
+		///	@param	data
+		///	ファイル上で前回渡したデータに続くデータ。
+		///	@param	length
+		///	@a data の長さ。
+		///	@note
+		///	すべての水平ラインをデコードした後に渡されたデータは無視されます。
+		///	@exception	InvalidDIBFormatException
+		///	ヘッダの内容が無効か、1水平ラインの長さが上限を超えているか、色パレットの範囲外のインデックスが含まれています。
+		///	@exception	NotImplementedException
+		///	画像の圧縮形式はサポートされていません。
+		///	@exception	InvalidOperationException
+		///	以前の呼び出しで例外が発生しています。
+		///	@exception
+		///	@a RowHandler がスローした例外はそのまま呼び出し元に送出されます。
+		void Feed(const char* data, size_t length);
+	private:
+		void LoadHead();
+		void DecodeRow(const uint8_t* data);
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibpushdecoder__
@@ -0,0 +1,82 @@
+//	stationaryorbit/graphics-dib/dibrowbatch
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibrowbatch__
+#define __stationaryorbit_graphics_dib_dibrowbatch__
+#include <vector>
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibloader.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	書き込み待ちの水平ラインをバッファに格納し、複数の水平ラインをまとめて @a DIBLoader に書き込みます。
+	///	@note
+	///	@a DIBRGBEncoder 、 @a DIBCoreBitmapEncoder および @a DIBTypedEncoder の書き込みで使用されます。
+	///	書き込み位置はファイル上の並び順での要素の番号で、呼び出し元が管理します。
+	class DIBRowBatch final
+	{
+	private:
+		///	書き込みを行う @a DIBLoader への参照。
+		DIBLoader& loader;
+		///	書き込み先のデータのオフセット。
+		size_t offset;
+		///	画像の幅。
+		int64_t width;
+		///	全体の要素数。
+		int64_t length;
+		///	ストライド(1水平軸ラインのデータ長)。
+		size_t stridelength;
+		///	1回の書き込みでまとめる水平ラインの数。
+		size_t batchrows;
+		///	書き込み待ちの水平ラインを格納するバッファ。
+		///	パディングを含むストライド単位で、ファイル上の並び順に格納されます。
+		std::vector<uint8_t> rowbuffer;
+		///	バッファの先頭の水平ラインのファイル上の行番号。
+		int64_t bufferrow;
+	public:
+		///	@a DIBRowBatch を初期化します。
+		///	@param	loader
+		///	書き込みを行う @a DIBLoader 。
+		///	@param	offset
+		///	書き込み先のデータのオフセット。
+		///	@param	size
+		///	画像の大きさ。
+		///	@param	stridelength
+		///	ストライド(1水平軸ラインのデータ長)。
+		///	@param	batchrows
+		///	1回の書き込みでまとめる水平ラインの数。
+		///	@exception	std::invalid_argument
+		///	@a batchrows に0が指定されました。
+		DIBRowBatch(DIBLoader& loader, size_t offset, const DisplayRectSize& size, size_t stridelength, size_t batchrows);
+
+		///	指定された書き込み位置を含む水平ラインの、バッファ上の先頭を取得します。
+		///	@note
+		///	@a current はバッファに格納されている水平ラインに含まれている必要があります。
+		[[nodiscard]] uint8_t* Row(int64_t current);
+		///	書き込み位置を進めた後に呼び出します。
+		///	@a batchrows 分の水平ラインが揃うか画像の末尾に達した場合、バッファに格納されているデータを書き込みます。
+		void Advance(int64_t current);
+		///	バッファに格納されているデータを書き込みます。
+		///	書き込み途中の水平ラインはストライド全体が書き込まれ、未書き込みのピクセルは0になります。
+		///	@param	current
+		///	現在の書き込み位置。
+		void Flush(int64_t current);
+		///	バッファの内容を破棄し、書き込み位置が初期位置に戻った状態にします。
+		void Reset();
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibrowbatch__
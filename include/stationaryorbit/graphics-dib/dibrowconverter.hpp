@@ -0,0 +1,172 @@
+//	stationaryorbit/graphics-dib/dibrowconverter
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibrowconverter__
+#define __stationaryorbit_graphics_dib_dibrowconverter__
+#include <vector>
+#include <optional>
+#include "stationaryorbit/graphics-core.color.hpp"
+#include "dibpixeldata.hpp"
+#include "dibheaders.hpp"
+#include "dibbitfields.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	Windows bitmap 画像の1水平ライン分のピクセルデータを一括して色に変換します。
+	class DIBRowConverter
+	{
+	public:
+		///	行単位の変換に使用する実装の選択。
+		enum class KernelSelection
+		{
+			///	実行環境に合わせて選択された実装を使用します。
+			Dispatched,
+			///	SIMD命令を使用しない実装を使用します。
+			///	SIMD命令を使用した実装の検証に使用します。
+			Scalar,
+		};
+	private:
+		///	各ピクセルのデータ長。
+		DIBBitDepth bitdepth;
+		///	インデックスカラーで使用する色パレット。
+		std::vector<RGB8_t> palette;
+		///	1バイトに含まれるインデックスを色に展開するための参照テーブル。
+		///	1ビット・4ビットのインデックスカラーでのみ使用されます。
+		std::vector<RGB8_t> unpacktable;
+		///	8ビットのインデックスを色に変換するための参照テーブル。
+		///	各要素は下位バイトから R, G, B の順に色を格納しています。
+		std::vector<uint32_t> indextable;
+		///	ビットフィールド形式で使用する色マスク。
+		std::optional<DIBBitFields> bitfields;
+	public:
+		///	無効な状態の @a DIBRowConverter をデフォルト構築します。
+		DIBRowConverter();
+		///	ダイレクトカラーの @a DIBRowConverter を初期化します。
+		///	@param	bitdepth
+		///	各ピクセルのデータ長。
+		///	@exception	std::invalid_argument
+		///	@a bitdepth にインデックスカラーのデータ長が指定されました。
+		///	インデックスカラーでは色パレットを指定するコンストラクタを使用します。
+		DIBRowConverter(DIBBitDepth bitdepth);
+		///	色パレットを使用する @a DIBRowConverter を初期化します。
+		///	@param	bitdepth
+		///	各ピクセルのデータ長。
+		///	@param	palette
+		///	インデックスカラーで使用する色パレット。
+		DIBRowConverter(DIBBitDepth bitdepth, const std::vector<RGB8_t>& palette);
+		///	ビットフィールド形式の @a DIBRowConverter を初期化します。
+		///	@param	bitdepth
+		///	各ピクセルのデータ長。
+		///	@param	bitfields
+		///	ビットフィールド形式で使用する色マスク。
+		///	@exception	InvalidDIBFormatException
+		///	@a bitdepth が16ビット・32ビットのいずれでもありません。
+		DIBRowConverter(DIBBitDepth bitdepth, const DIBBitFields& bitfields);
+
+		///	このオブジェクトの各ピクセルのデータ長を取得します。
+		[[nodiscard]] DIBBitDepth BitDepth() const { return bitdepth; }
+		///	1水平ライン分のピクセルデータを色に変換します。
+		///	@param	src
+		///	変換元のピクセルデータ。
+		///	@param	dest
+		///	変換した色の格納先。
+		///	@a count の長さの領域が確保されている必要があります。
+		///	@param	count
+		///	変換するピクセルの数。
+		void Convert(const uint8_t* src, RGB8_t* dest, size_t count) const;
+		///	1水平ライン分の色をピクセルデータに変換します。
+		///	@param	src
+		///	変換元の色。
+		///	@param	dest
+		///	変換したピクセルデータの格納先。
+		///	パディングを含まない1水平ライン分の長さの領域が確保されている必要があります。
+		///	@param	count
+		///	変換するピクセルの数。
+		///	@note
+		///	インデックスカラーでは色パレットの中から最も近い色のインデックスに変換されます。
+		///	@exception	InvalidOperationException
+		///	インデックスカラーで色パレットが空です。
+		void Pack(const RGB8_t* src, uint8_t* dest, size_t count) const;
+
+		///	16ビット(RGB555)のピクセルデータを色に変換します。
+		///	@note
+		///	各チャネルは上位ビットの複製により8ビットに拡張されます。
+		static void ConvertRGB555(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel = KernelSelection::Dispatched);
+		///	16ビット(RGB565)のピクセルデータを色に変換します。
+		///	@note
+		///	各チャネルは上位ビットの複製により8ビットに拡張されます。
+		static void ConvertRGB565(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel = KernelSelection::Dispatched);
+		///	24ビット(BGR)のピクセルデータを色に変換します。
+		///	@note
+		///	実行環境で使用可能な場合、SIMD命令を使用した変換が行われます。
+		///	@a kernel に @a KernelSelection::Scalar を指定した場合は常にSIMD命令を使用しない変換が行われます。
+		static void ConvertBGR24(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel = KernelSelection::Dispatched);
+		///	32ビット(BGRX)のピクセルデータを色に変換します。
+		///	@note
+		///	実行環境で使用可能な場合、SIMD命令を使用した変換が行われます。
+		///	@a kernel に @a KernelSelection::Scalar を指定した場合は常にSIMD命令を使用しない変換が行われます。
+		static void ConvertBGRX32(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel = KernelSelection::Dispatched);
+		///	色を16ビット(RGB555)のピクセルデータに変換します。
+		///	@param	src
+		///	変換元の色。
+		///	@param	dest
+		///	変換したピクセルデータの格納先。
+		///	@a count*2 の長さの領域が確保されている必要があります。
+		///	@param	count
+		///	変換するピクセルの数。
+		///	@param	kernel
+		///	変換に使用する実装。
+		static void PackRGB555(const RGB8_t* src, uint8_t* dest, size_t count, KernelSelection kernel = KernelSelection::Dispatched);
+		///	色を16ビット(RGB565)のピクセルデータに変換します。
+		///	@param	src
+		///	変換元の色。
+		///	@param	dest
+		///	変換したピクセルデータの格納先。
+		///	@a count*2 の長さの領域が確保されている必要があります。
+		///	@param	count
+		///	変換するピクセルの数。
+		///	@param	kernel
+		///	変換に使用する実装。
+		static void PackRGB565(const RGB8_t* src, uint8_t* dest, size_t count, KernelSelection kernel = KernelSelection::Dispatched);
+		///	16ビット・24ビット・32ビットおよび8ビットのインデックスの変換で使用されている実装の名前を取得します。
+		///	@return
+		///	@a "avx2" @a "ssse3" @a "scalar" @a "generic" のいずれかを返します。
+		///	@a "generic" は @a RGB8_t のメモリ配置がバイト列としての変換に適さない場合に使用されます。
+		[[nodiscard]] static const char* KernelName();
+		///	1ビットのインデックスを色パレットを使用して色に変換します。
+		///	@exception	InvalidDIBFormatException
+		///	色パレットの範囲外のインデックスが含まれています。
+		static void ConvertIndexed1(const uint8_t* src, RGB8_t* dest, size_t count, const std::vector<RGB8_t>& palette);
+		///	4ビットのインデックスを色パレットを使用して色に変換します。
+		///	@exception	InvalidDIBFormatException
+		///	色パレットの範囲外のインデックスが含まれています。
+		static void ConvertIndexed4(const uint8_t* src, RGB8_t* dest, size_t count, const std::vector<RGB8_t>& palette);
+		///	8ビットのインデックスを色パレットを使用して色に変換します。
+		///	@exception	InvalidDIBFormatException
+		///	色パレットの範囲外のインデックスが含まれています。
+		static void ConvertIndexed8(const uint8_t* src, RGB8_t* dest, size_t count, const std::vector<RGB8_t>& palette);
+	private:
+		void BuildUnpackTable();
+		void BuildIndexTable();
+		void ConvertUnpacked(const uint8_t* src, RGB8_t* dest, size_t count) const;
+		void ConvertPacked8(const uint8_t* src, RGB8_t* dest, size_t count) const;
+		void ConvertBitFields(const uint8_t* src, RGB8_t* dest, size_t count) const;
+		void PackBitFields(const RGB8_t* src, uint8_t* dest, size_t count) const;
+		void PackIndexed(const RGB8_t* src, uint8_t* dest, size_t count) const;
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibrowconverter__
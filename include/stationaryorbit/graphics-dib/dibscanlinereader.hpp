@@ -0,0 +1,164 @@
+//	stationaryorbit/graphics-dib/dibscanlinereader
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibscanlinereader__
+#define __stationaryorbit_graphics_dib_dibscanlinereader__
+#include <vector>
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibheaders.hpp"
+#include "dibloader.hpp"
+#include "dibrowconverter.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	水平ライン単位の読み込みに必要な、 Windows bitmap 画像のピクセル配列の形式です。
+	struct DIBScanlineFormat final
+	{
+		///	既定の1水平ラインの長さの上限。
+		static constexpr size_t DefaultMaxStrideLength = size_t(16) * 1024 * 1024;
+
+		///	各ピクセルのデータ長。
+		DIBBitDepth BitDepth;
+		///	画像の大きさ。
+		DisplayRectSize Size;
+		///	画像がトップダウン形式(情報ヘッダの縦幅が負の値)であるか。
+		bool TopDown;
+		///	ファイル先頭からピクセル配列までのオフセット。
+		size_t Offset;
+		///	パディングを含む1水平ラインの長さ。
+		size_t StrideLength;
+		///	ピクセルデータを色に変換する @a DIBRowConverter 。
+		DIBRowConverter Converter;
+
+		///	ファイル上での水平ラインの番号から、画像上でのY座標を求めます。
+		[[nodiscard]] int32_t ResolveY(int32_t index) const { return (TopDown)?(index):(Size.Height() - 1 - index); }
+
+		///	@a DIBLoader からヘッダ・色マスク・色パレットを読み込み、ピクセル配列の形式を求めます。
+		///	@param	loader
+		///	読み込みに使用する @a DIBLoader 。
+		///	@param	maxstridelength
+		///	許容するパディングを含む1水平ラインの長さの上限。
+		///	信頼できないデータから過大なメモリを確保しないために使用します。
+		///	@note
+		///	読み込みはファイル上で前方にあるものから順に行われます。
+		///	@exception	InvalidOperationException
+		///	無効な状態のloaderが渡されました。
+		///	@exception	InvalidDIBFormatException
+		///	ヘッダの内容が無効か、画像の大きさが0であるか、1水平ラインの長さが @a maxstridelength を超えています。
+		///	@exception	NotImplementedException
+		///	画像の圧縮形式はサポートされていません。
+		[[nodiscard]] static DIBScanlineFormat Load(DIBLoader& loader, size_t maxstridelength = DefaultMaxStrideLength);
+		///	@a Load に必要なファイル先頭からのデータの長さを求めます。
+		///	@param	data
+		///	ファイル先頭からのデータ。
+		///	@param	length
+		///	@a data の長さ。
+		///	@return
+		///	必要な長さを返します。
+		///	@a length の範囲のデータからは求めることができない場合、求めるために必要な @a length より大きい長さを返します。
+		///	@exception	InvalidDIBFormatException
+		///	ファイルヘッダ、情報ヘッダの長さ、BitCount、または色パレットの長さが無効です。
+		[[nodiscard]] static size_t HeadLength(const char* data, size_t length);
+	private:
+		[[nodiscard]] static size_t ResolvePaletteSize(DIBBitDepth bitdepth, uint32_t clrused);
+		static void ValidateBitCount(DIBCompressionMethod compression, DIBBitDepth bitdepth);
+		static void ValidateStrideLength(size_t stridelength, size_t maxstridelength);
+	};
+	///	@a DIBLoader から Windows bitmap 画像を水平ライン単位で先頭から順に読み込みます。
+	///	@note
+	///	水平ラインはファイル上の並び順で読み込まれるため、ボトムアップ形式の画像では画像の下端の水平ラインから順に得られます。
+	///	得られた水平ラインの画像上でのY座標は @a CurrentY で取得できます。
+	///	メモリ上には最大で @a RowCount 本分のピクセルデータと、変換済みの1水平ラインのみを保持します。
+	///	ローダーへの読み込みは常に前方の位置に対して行われ、読み込み済みの位置に戻ることはありません。
+	///	非圧縮(RGB)およびビットフィールド形式の画像のみをサポートします。
+	class DIBScanlineReader final
+	{
+	public:
+		///	既定の一度に読み込む水平ラインの数。
+		static constexpr int32_t DefaultRowCount = 16;
+	private:
+		DIBLoader& loader;
+		DIBScanlineFormat format;
+		int32_t rowcount;
+		///	読み込み済みのピクセルデータ。
+		std::vector<uint8_t> buffer;
+		///	@a buffer の先頭の水平ラインのファイル上での番号。
+		int32_t bufferfirst;
+		///	@a buffer に格納されている水平ラインの数。
+		int32_t buffercount;
+		///	現在の水平ラインのファイル上での番号。
+		int32_t current;
+		///	現在の水平ラインの色。
+		std::vector<RGB8_t> row;
+	public:
+		///	@a DIBScanlineReader を初期化し、ヘッダ・色パレットを読み込みます。
+		///	@param	loader
+		///	読み込みに使用する @a DIBLoader 。
+		///	このオブジェクトはローダーを参照するため、ローダーはこのオブジェクトより長く生存している必要があります。
+		///	@param	rowcount
+		///	一度に読み込む水平ラインの数。メモリ上に保持するピクセルデータの上限になります。
+		///	@param	maxstridelength
+		///	許容するパディングを含む1水平ラインの長さの上限。
+		///	@exception	std::invalid_argument
+		///	@a rowcount に0以下の値が指定されました。
+		///	@exception	InvalidOperationException
+		///	無効な状態のloaderが渡されました。
+		///	@exception	InvalidDIBFormatException
+		///	ヘッダの内容が無効か、1水平ラインの長さが @a maxstridelength を超えています。
+		///	@exception	NotImplementedException
+		///	画像の圧縮形式はサポートされていません。
+		DIBScanlineReader(DIBLoader& loader, int32_t rowcount = DefaultRowCount, size_t maxstridelength = DIBScanlineFormat::DefaultMaxStrideLength);
+		DIBScanlineReader(const DIBScanlineReader&) = delete;
+		DIBScanlineReader(DIBScanlineReader&&) = default;
+
+		///	ピクセル配列の形式を取得します。
+		[[nodiscard]] const DIBScanlineFormat& Format() const { return format; }
+		///	画像の大きさを取得します。
+		[[nodiscard]] const DisplayRectSize& Size() const { return format.Size; }
+		///	各ピクセルのデータ長を取得します。
+		[[nodiscard]] DIBBitDepth BitDepth() const { return format.BitDepth; }
+		///	画像がトップダウン形式(情報ヘッダの縦幅が負の値)であるかを取得します。
+		[[nodiscard]] bool IsTopDown() const { return format.TopDown; }
+		///	一度に読み込む水平ラインの数を取得します。
+		[[nodiscard]] int32_t RowCount() const { return rowcount; }
+
+		///	次の水平ラインに進めます。
+		///	@return
+		///	水平ラインが得られた場合は @a true 、すべての水平ラインを読み終えた場合は @a false を返します。
+		///	@exception	InvalidDIBFormatException
+		///	色パレットの範囲外のインデックスが含まれています。
+		bool Next();
+		///	現在の位置が値を持っているかを取得します。
+		[[nodiscard]] bool HasValue() const { return (0 <= current)&&(current < format.Size.Height()); }
+		///	これまでに得られた水平ラインの数を取得します。
+		[[nodiscard]] int32_t RowsRead() const;
+		///	現在の水平ラインの画像上でのY座標を取得します。
+		///	@exception	InvalidOperationException
+		///	現在の位置は値を持っていません。
+		[[nodiscard]] int32_t CurrentY() const;
+		///	現在の水平ラインの色を取得します。
+		///	@return
+		///	@a Size().Width() 個の色の先頭を返します。
+		///	返される領域は次に @a Next を呼び出すまで有効です。
+		///	@exception	InvalidOperationException
+		///	現在の位置は値を持っていません。
+		[[nodiscard]] const RGB8_t* Current() const;
+	private:
+		void Fill();
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibscanlinereader__
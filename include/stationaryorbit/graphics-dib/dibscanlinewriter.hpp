@@ -0,0 +1,140 @@
+//	stationaryorbit/graphics-dib/dibscanlinewriter
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibscanlinewriter__
+#define __stationaryorbit_graphics_dib_dibscanlinewriter__
+#include <vector>
+#include <variant>
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibheaders.hpp"
+#include "dibloader.hpp"
+#include "dibrowconverter.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	@a DIBScanlineWriter に水平ラインを渡す順序。
+	enum class DIBScanlineOrder
+	{
+		///	ファイル上の並び順。画像の下端の水平ラインから順に渡します。
+		File,
+		///	画像上の並び順。画像の上端の水平ラインから順に渡します。
+		Logical
+	};
+	///	@a DIBLoader に Windows bitmap 画像を水平ライン単位で書き込みます。
+	///	@note
+	///	ヘッダは構築時に書き込まれ、水平ラインはパディングを含めて @a WriteRow の呼び出しごとに直ちに書き込まれます。
+	///	画像全体を保持しないため、メモリ上には1水平ライン分のピクセルデータのみを保持します。
+	///	ファイルヘッダの @a FileSize および情報ヘッダの @a SizeImage は画像の大きさから求められ、構築時に確定します。
+	///	@a DIBScanlineOrder::File の場合、ローダーへの書き込みは常に前方の位置に対して行われるため、
+	///	@a DIBOutputStreamLoader を使用してシークできない出力へ書き込むことができます。
+	class DIBScanlineWriter final
+	{
+	private:
+		DIBLoader& loader;
+		DIBFileHeader fhead;
+		std::variant<DIBCoreHeader, DIBInfoHeader> ihead;
+		DisplayRectSize size;
+		DIBScanlineOrder order;
+		size_t stridelength;
+		DIBRowConverter packer;
+		///	書き込むピクセルデータ。パディングは常に0で埋められています。
+		std::vector<uint8_t> rowbuffer;
+		int32_t written;
+		bool closed;
+	public:
+		///	InfoHeader を持つ画像の @a DIBScanlineWriter を初期化し、ヘッダを書き込みます。
+		///	@param	loader
+		///	書き込みに使用する @a DIBLoader 。
+		///	このオブジェクトはローダーを参照するため、ローダーはこのオブジェクトより長く生存している必要があります。
+		///	@param	header
+		///	書き込む画像の情報ヘッダ。 @a SizeImage の値は画像の大きさから求めた値に置き換えられます。
+		///	@param	order
+		///	水平ラインを渡す順序。
+		///	@exception	std::invalid_argument
+		///	@a header の内容が無効です。
+		///	@exception	NotImplementedException
+		///	指定された圧縮形式・ビット幅の書き込みは実装されていません。
+		DIBScanlineWriter(DIBLoader& loader, const DIBInfoHeader& header, DIBScanlineOrder order = DIBScanlineOrder::File);
+		///	CoreHeader を持つ画像の @a DIBScanlineWriter を初期化し、ヘッダを書き込みます。
+		///	@param	loader
+		///	書き込みに使用する @a DIBLoader 。
+		///	このオブジェクトはローダーを参照するため、ローダーはこのオブジェクトより長く生存している必要があります。
+		///	@param	header
+		///	書き込む画像の情報ヘッダ。
+		///	@param	order
+		///	水平ラインを渡す順序。
+		///	@exception	std::invalid_argument
+		///	@a header の内容が無効です。
+		///	@exception	NotImplementedException
+		///	指定されたビット幅の書き込みは実装されていません。
+		DIBScanlineWriter(DIBLoader& loader, const DIBCoreHeader& header, DIBScanlineOrder order = DIBScanlineOrder::File);
+		DIBScanlineWriter(const DIBScanlineWriter&) = delete;
+		DIBScanlineWriter(DIBScanlineWriter&&) = delete;
+		///	@a Close が呼び出されていない場合、例外を無視して @a Close を行います。
+		~DIBScanlineWriter();
+
+		///	画像の大きさを取得します。
+		[[nodiscard]] const DisplayRectSize& Size() const { return size; }
+		///	水平ラインを渡す順序を取得します。
+		[[nodiscard]] DIBScanlineOrder Order() const { return order; }
+		///	これまでに書き込んだ水平ラインの数を取得します。
+		[[nodiscard]] int32_t RowsWritten() const { return written; }
+		///	すべての水平ラインを書き込んだかを取得します。
+		[[nodiscard]] bool IsCompleted() const { return size.Height() <= written; }
+		///	@a Close が呼び出されたかを取得します。
+		[[nodiscard]] bool IsClosed() const { return closed; }
+		///	次に書き込む水平ラインの画像上でのY座標を取得します。
+		///	@exception	InvalidOperationException
+		///	すべての水平ラインを書き込み済みです。
+		[[nodiscard]] int32_t NextY() const;
+
+		///	次の水平ラインを書き込みます。
+		///	@param	row
+		///	書き込む水平ラインの色。 @a Size().Width() の長さの領域が確保されている必要があります。
+		///	@exception	InvalidOperationException
+		///	すべての水平ラインを書き込み済みか、 @a Close が呼び出されています。
+		void WriteRow(const RGB8_t* row);
+		///	次の水平ラインを書き込みます。
+		///	@param	row
+		///	書き込む水平ラインの色。
+		///	@exception	std::invalid_argument
+		///	@a row の長さが画像の横幅と一致しません。
+		///	@exception	InvalidOperationException
+		///	すべての水平ラインを書き込み済みか、 @a Close が呼び出されています。
+		void WriteRow(const std::vector<RGB8_t>& row);
+		///	画像全体を書き込みます。
+		///	@param	image
+		///	書き込む画像。
+		///	@param	threads
+		///	使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@note
+		///	水平ラインの帯ごとに変換を行い、 @a Order に関わらずファイル上の並び順で書き込みます。
+		///	@exception	std::invalid_argument
+		///	@a image の大きさが画像の大きさと一致しないか、 @a image が @a DIBImageView で @a threads に1以外が指定されました。
+		///	@exception	InvalidOperationException
+		///	すでに水平ラインが書き込まれているか、 @a Close が呼び出されています。
+		void WriteImage(const Image<RGB8_t>& image, size_t threads = 1);
+		///	書き込みを完了し、ローダーを同期します。
+		///	2回目以降の呼び出しでは何もしません。
+		///	@exception	InvalidOperationException
+		///	書き込まれていない水平ラインがあります。
+		void Close();
+	private:
+		void WriteHead();
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibscanlinewriter__
@@ -0,0 +1,126 @@
+//	stationaryorbit/graphics-dib/dibtilecache
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibtilecache__
+#define __stationaryorbit_graphics_dib_dibtilecache__
+#include <list>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "stationaryorbit/graphics-core.image.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	@a DIBTileCache の統計情報。
+	struct DIBTileCacheStatistics final
+	{
+		///	キャッシュされたタイルを使用した回数。
+		size_t Hit;
+		///	タイルをデコードした回数。
+		size_t Miss;
+		///	容量を超えたためにタイルを破棄した回数。
+		size_t Eviction;
+
+		///	キャッシュのヒット率を取得します。
+		[[nodiscard]] constexpr double HitRatio() const { return ((Hit + Miss) != 0)?(double(Hit) / double(Hit + Miss)):(0.0); }
+	};
+	///	デコードされた画像を正方形のタイル単位で保持するキャッシュです。
+	///	@note
+	///	タイルは画像の左上を基準に整列し、画像の右端・下端のタイルは画像の範囲に切り詰められます。
+	///	保持しているタイルの合計のバイト数が容量を超える場合、最も長く使用されていないタイルから破棄します。
+	///	このクラスはスレッドセーフではありません。
+	class DIBTileCache final
+	{
+	public:
+		///	既定のタイルの一辺の長さ(ピクセル単位)。
+		static constexpr int32_t DefaultTileSize = 256;
+		///	既定のキャッシュの容量(バイト単位)。
+		static constexpr size_t DefaultCapacity = 64U * 1024U * 1024U;
+		///	タイルのデコードを行う関数。
+		///	@a area の範囲のピクセルをデコードし、画像上の並び順で @a dest に格納します。
+		typedef std::function<void(const DisplayRectangle& area, RGB8_t* dest)> DecodeFunction;
+	private:
+		struct Tile
+		{
+			uint64_t key;
+			DisplayRectangle area;
+			std::vector<RGB8_t> data;
+		};
+		DisplayRectSize imagesize;
+		int32_t tilesize;
+		size_t capacity;
+		size_t usage;
+		std::list<Tile> tiles;
+		std::unordered_map<uint64_t, std::list<Tile>::iterator> tileindex;
+		DIBTileCacheStatistics statistics;
+	public:
+		///	無効なキャッシュを構築します。
+		DIBTileCache();
+		///	@a DIBTileCache を初期化します。
+		///	@param	imagesize
+		///	キャッシュする画像の大きさ。
+		///	@param	capacity
+		///	保持するタイルの合計の最大バイト数。 0 を指定した場合、キャッシュは無効になります。
+		///	@param	tilesize
+		///	タイルの一辺の長さ(ピクセル単位)。
+		///	@exception	std::invalid_argument
+		///	@a tilesize に0以下の値が指定されました。
+		DIBTileCache(const DisplayRectSize& imagesize, size_t capacity, int32_t tilesize = DefaultTileSize);
+
+		///	キャッシュが有効かを取得します。
+		[[nodiscard]] bool IsEnabled() const { return capacity != 0; }
+		///	タイルの一辺の長さを取得します。
+		[[nodiscard]] int32_t TileSize() const { return tilesize; }
+		///	保持するタイルの合計の最大バイト数を取得します。
+		[[nodiscard]] size_t Capacity() const { return capacity; }
+		///	保持しているタイルの合計のバイト数を取得します。
+		[[nodiscard]] size_t Usage() const { return usage; }
+		///	キャッシュの統計情報を取得します。
+		[[nodiscard]] const DIBTileCacheStatistics& Statistics() const { return statistics; }
+
+		///	指定された位置のピクセルの色を取得します。
+		///	@param	pos
+		///	取得するピクセルの位置。
+		///	@param	decode
+		///	タイルがキャッシュされていない場合に使用する関数。
+		///	@exception	std::out_of_range
+		///	指定された座標はこの画像領域を超えています。
+		[[nodiscard]] RGB8_t Get(const DisplayPoint& pos, const DecodeFunction& decode);
+		///	指定された領域の色を @a WritableImage にコピーします。
+		///	@param	dest
+		///	コピー先の @a WritableImage 。
+		///	@param	area
+		///	コピーする領域。
+		///	@param	destorigin
+		///	@a dest 上での @a area の原点の位置。
+		///	@param	decode
+		///	タイルがキャッシュされていない場合に使用する関数。
+		///	@exception	std::out_of_range
+		///	@a area がこの画像領域を超えています。
+		void CopyTo(WritableImage<RGB8_t>& dest, const DisplayRectangle& area, const DisplayPoint& destorigin, const DecodeFunction& decode);
+		///	指定された領域と重なるタイルを破棄します。
+		void Invalidate(const DisplayRectangle& area) noexcept;
+		///	保持しているタイルをすべて破棄します。
+		void Clear() noexcept;
+		///	統計情報をリセットします。
+		void ResetStatistics() noexcept;
+	private:
+		[[nodiscard]] uint64_t ResolveKey(int32_t tx, int32_t ty) const { return (uint64_t(uint32_t(ty)) << 32) | uint64_t(uint32_t(tx)); }
+		const Tile& Fetch(int32_t tx, int32_t ty, const DecodeFunction& decode);
+	};
+}
+#endif // __stationaryorbit_graphics_dib_dibtilecache__
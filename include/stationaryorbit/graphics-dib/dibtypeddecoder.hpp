@@ -0,0 +1,392 @@
+//	stationaryorbit/graphics-dib/dibtypeddecoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef __stationaryorbit_graphics_dib_dibtypeddecoder__
+#define __stationaryorbit_graphics_dib_dibtypeddecoder__
+#include <type_traits>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <stdexcept>
+#include "stationaryorbit/core.exception.hpp"
+#include "stationaryorbit/graphics-core.image.hpp"
+#include "dibloader.hpp"
+#include "dibrowbatch.hpp"
+#include "dibpixeldata.hpp"
+namespace zawa_ch::StationaryOrbit::Graphics::DIB
+{
+	///	実行時のビット幅に対応する特殊化を選択するヘルパークラスです。
+	class DIBBitDepthDispatcher final
+	{
+		DIBBitDepthDispatcher() = delete;
+		DIBBitDepthDispatcher(const DIBBitDepthDispatcher&) = delete;
+		DIBBitDepthDispatcher(DIBBitDepthDispatcher&&) = delete;
+		~DIBBitDepthDispatcher() = delete;
+	public:
+		///	@a bitdepth に対応する @a std::integral_constant を引数として @a func を呼び出します。
+		///	@param	bitdepth
+		///	選択するビット幅。
+		///	@param	func
+		///	@a std::integral_constant<DIBBitDepth,D> を1つ受け取る関数。
+		///	すべてのビット幅について同じ型の値を返す必要があります。
+		///	@exception	std::invalid_argument
+		///	@a bitdepth の内容が無効です。
+		template<class F>
+		static decltype(auto) Dispatch(DIBBitDepth bitdepth, F&& func)
+		{
+			switch(bitdepth)
+			{
+				case DIBBitDepth::Bit1: { return func(std::integral_constant<DIBBitDepth, DIBBitDepth::Bit1>()); }
+				case DIBBitDepth::Bit4: { return func(std::integral_constant<DIBBitDepth, DIBBitDepth::Bit4>()); }
+				case DIBBitDepth::Bit8: { return func(std::integral_constant<DIBBitDepth, DIBBitDepth::Bit8>()); }
+				case DIBBitDepth::Bit16: { return func(std::integral_constant<DIBBitDepth, DIBBitDepth::Bit16>()); }
+				case DIBBitDepth::Bit24: { return func(std::integral_constant<DIBBitDepth, DIBBitDepth::Bit24>()); }
+				case DIBBitDepth::Bit32: { return func(std::integral_constant<DIBBitDepth, DIBBitDepth::Bit32>()); }
+				default: { throw std::invalid_argument("bitdepthの内容が無効です。"); }
+			}
+		}
+	};
+
+	///	ビット幅ごとのピクセル配列のレイアウトを表します。
+	///	@param	Depth
+	///	各ピクセルのデータ長。
+	template<DIBBitDepth Depth>
+	struct DIBTypedLayout final
+	{
+		///	ピクセルデータの型。
+		typedef DIBPixelData<Depth> ValueType;
+		///	1ピクセルのビット数。
+		static constexpr size_t PixelBits = size_t(Depth);
+		///	1ピクセルのデータ長(バイト単位)。1バイトに複数のピクセルを格納する場合は 1 です。
+		static constexpr size_t PixelLength = (PixelBits + 7) / 8;
+		///	1バイトに複数のピクセルを格納するかを表します。
+		static constexpr bool IsPacked = PixelBits < 8;
+
+		///	水平ラインのパディングを含まないデータ長を取得します。
+		[[nodiscard]] static constexpr size_t RowLength(int32_t width) { return ((PixelBits * size_t(width)) + 7) / 8; }
+		///	ストライド(1水平軸ラインのデータ長)を取得します。
+		[[nodiscard]] static constexpr size_t StrideLength(int32_t width) { return ((RowLength(width) + 3) / 4) * 4; }
+		///	水平ラインの先頭から @a x 番目のピクセルが含まれるバイトの位置を取得します。
+		[[nodiscard]] static constexpr size_t ByteOffset(size_t x) { return (PixelBits * x) / 8; }
+		///	水平ラインの先頭から @a x 番目のピクセルが含まれるバイトの先頭にあるピクセルの位置を取得します。
+		[[nodiscard]] static constexpr size_t ByteOrigin(size_t x) { return (ByteOffset(x) * 8) / PixelBits; }
+		///	水平ラインの先頭から [x0, x1) の範囲のピクセルが含まれるバイト数を取得します。
+		[[nodiscard]] static constexpr size_t SpanLength(size_t x0, size_t x1) { return (((PixelBits * x1) + 7) / 8) - ByteOffset(x0); }
+
+		///	水平ラインのデータから @a x 番目のピクセルを取り出します。
+		///	@param	row
+		///	水平ラインの先頭のバイトを指すポインタ。
+		[[nodiscard]] static constexpr ValueType Extract(const uint8_t* row, size_t x)
+		{
+			if constexpr (IsPacked)
+			{
+				//	各バイトの上位ビットが左側のピクセルを表す
+				auto shift = 8 - PixelBits - ((PixelBits * x) % 8);
+				return ValueType((row[ByteOffset(x)] >> shift) & ((1U << PixelBits) - 1));
+			}
+			else
+			{
+				//	ピクセルデータはリトルエンディアンで格納されている
+				auto src = row + (x * PixelLength);
+				auto value = uint32_t();
+				for (auto i: Range<size_t>(0, PixelLength).GetStdIterator()) { value |= uint32_t(src[i]) << (8 * i); }
+				return ValueType(value);
+			}
+		}
+		///	水平ラインのデータの @a x 番目にピクセルを格納します。
+		///	1バイトに複数のピクセルを格納する場合、同じバイトに含まれる他のピクセルは保持されます。
+		///	@param	row
+		///	水平ラインの先頭のバイトを指すポインタ。
+		static constexpr void Insert(uint8_t* row, size_t x, const ValueType& value)
+		{
+			auto data = uint32_t(value);
+			if constexpr (IsPacked)
+			{
+				auto shift = 8 - PixelBits - ((PixelBits * x) % 8);
+				auto mask = uint8_t(((1U << PixelBits) - 1) << shift);
+				auto& target = row[ByteOffset(x)];
+				target = uint8_t((target & ~mask) | ((data << shift) & mask));
+			}
+			else
+			{
+				auto dest = row + (x * PixelLength);
+				for (auto i: Range<size_t>(0, PixelLength).GetStdIterator()) { dest[i] = uint8_t(data >> (8 * i)); }
+			}
+		}
+	};
+
+	///	Windows bitmap 画像の無圧縮のピクセル配列を、ビット幅を静的に指定して読み書きします。
+	///	@param	Depth
+	///	各ピクセルのデータ長。
+	///	@note
+	///	@a DIBRGBDecoder と異なり、値の受け渡しに @a std::variant を使用せず、ビット幅による分岐はコンパイル時に解決されます。
+	///	実行時のビット幅から特殊化を選択するには @a DIBBitDepthDispatcher を使用します。
+	template<DIBBitDepth Depth>
+	class DIBTypedDecoder final
+	{
+	public:
+		typedef DIBTypedLayout<Depth> Layout;
+		/// データの受け渡しに用いる型。
+		typedef typename Layout::ValueType ValueType;
+	private:
+		///	読み書きを行う @a DIBLoader への参照。
+		DIBLoader& loader;
+		///	ピクセル配列のオフセット。
+		size_t offset;
+		///	画像の大きさ。
+		DisplayRectSize size;
+		///	ストライド(1水平軸ラインのデータ長)。
+		size_t stridelength;
+		///	1水平軸ラインのパディングを含まないデータ長。
+		size_t rowlength;
+		///	読み込みに使用するバッファ。
+		std::vector<uint8_t> buffer;
+	public:
+		DIBTypedDecoder(DIBLoader& loader, size_t offset, const DisplayRectSize& size)
+			: loader(loader), offset(offset), size(size), stridelength(Layout::StrideLength(size.Width())), rowlength(Layout::RowLength(size.Width())), buffer()
+		{}
+
+		///	画像の大きさを取得します。
+		[[nodiscard]] const DisplayRectSize& Size() const { return size; }
+		///	1水平軸ラインのデータ長(バイト単位)を取得します。
+		[[nodiscard]] size_t StrideLength() const { return stridelength; }
+		///	指定された位置のピクセルを読み込みます。
+		///	@exception	std::out_of_range
+		///	指定された座標はこの画像領域を超えています。
+		[[nodiscard]] ValueType Get(const DisplayPoint& pos)
+		{
+			CheckPos(pos);
+			return GetUnchecked(pos);
+		}
+		///	範囲の検査を行わずに、指定された位置のピクセルを読み込みます。
+		[[nodiscard]] ValueType GetUnchecked(const DisplayPoint& pos)
+		{
+			auto data = std::array<uint8_t, Layout::PixelLength>();
+			DIBLoaderHelper::Read(loader, (char*)data.data(), offset + PixelOffset(pos), Layout::PixelLength);
+			//	1バイトに複数のピクセルを格納する場合は、読み込んだバイトの中の位置で取り出す
+			if constexpr (Layout::IsPacked) { return Layout::Extract(data.data(), size_t(pos.X()) % (8 / Layout::PixelBits)); }
+			else { return Layout::Extract(data.data(), 0); }
+		}
+		///	指定された位置にピクセルを書き込みます。
+		///	@exception	std::out_of_range
+		///	指定された座標はこの画像領域を超えています。
+		void Set(const DisplayPoint& pos, const ValueType& value)
+		{
+			CheckPos(pos);
+			auto data = std::array<uint8_t, Layout::PixelLength>();
+			auto tgt = offset + PixelOffset(pos);
+			if constexpr (Layout::IsPacked)
+			{
+				//	同じバイトに含まれる他のピクセルを保持して書き込む
+				DIBLoaderHelper::Read(loader, (char*)data.data(), tgt, Layout::PixelLength);
+				Layout::Insert(data.data(), size_t(pos.X()) % (8 / Layout::PixelBits), value);
+			}
+			else { Layout::Insert(data.data(), 0, value); }
+			loader.Write((const char*)data.data(), tgt, Layout::PixelLength);
+		}
+		///	指定された範囲の水平ラインを1回の読み込みで取得し、ピクセルデータに展開します。
+		///	@param	y0
+		///	読み込む範囲の先頭の水平ラインの画像上のY座標。
+		///	@param	y1
+		///	読み込む範囲の末尾の次の水平ラインの画像上のY座標。
+		///	@param	dest
+		///	展開したピクセルデータの格納先。
+		///	画像の幅*(y1-y0) の長さの領域が確保されている必要があります。
+		///	ピクセルデータは画像上の並び順(画像の上から下)で格納されます。
+		///	@exception	std::out_of_range
+		///	指定された範囲はこの画像領域を超えています。
+		void ReadRows(int32_t y0, int32_t y1, ValueType* dest)
+		{
+			if ( (y0 < 0)||(y1 < y0)||(size.Height() < y1) ) { throw std::out_of_range("指定された範囲はこの画像領域を超えています。"); }
+			if (y0 == y1) { return; }
+			buffer.resize(stridelength * (y1 - y0));
+			DIBLoaderHelper::Read(loader, (char*)buffer.data(), offset + (stridelength * (size.Height() - y1)), (stridelength * (y1 - y0 - 1)) + rowlength);
+			auto width = size_t(size.Width());
+			//	ファイル上の並びは画像の下から上であるため、逆順に展開する
+			for (auto i: Range<int32_t>(0, y1 - y0).GetStdIterator())
+			{
+				auto src = buffer.data() + (stridelength * i);
+				auto row = dest + (width * (y1 - y0 - 1 - i));
+				for (auto x: Range<size_t>(0, width).GetStdIterator()) { row[x] = Layout::Extract(src, x); }
+			}
+		}
+		///	指定された位置からファイル上の並び順で連続するピクセルを読み込みます。
+		///	水平ラインごとに1回の読み込みで取得します。
+		///	@param	pos
+		///	読み込みを開始する位置。
+		///	@param	count
+		///	読み込むピクセルの数。
+		///	水平ラインの末尾に達した場合は、1つ上の水平ラインの先頭から続けて読み込みます。
+		///	@param	dest
+		///	読み込んだピクセルデータの格納先。
+		///	@exception	std::out_of_range
+		///	指定された範囲はこの画像領域を超えています。
+		void ReadSpan(const DisplayPoint& pos, size_t count, ValueType* dest)
+		{
+			ForEachSpanRow(pos, count, [&](size_t tgt, size_t x0, size_t x1, size_t done)
+			{
+				auto origin = Layout::ByteOrigin(x0);
+				buffer.resize(Layout::SpanLength(x0, x1));
+				DIBLoaderHelper::Read(loader, (char*)buffer.data(), tgt + Layout::ByteOffset(x0), buffer.size());
+				for (auto x: Range<size_t>(x0, x1).GetStdIterator()) { dest[done + (x - x0)] = Layout::Extract(buffer.data(), x - origin); }
+			});
+		}
+		///	指定された位置からファイル上の並び順で連続するピクセルを書き込みます。
+		///	水平ラインごとに1回の書き込みで格納します。
+		///	@param	pos
+		///	書き込みを開始する位置。
+		///	@param	count
+		///	書き込むピクセルの数。
+		///	@param	src
+		///	書き込むピクセルデータ。
+		///	@exception	std::out_of_range
+		///	指定された範囲はこの画像領域を超えています。
+		void WriteSpan(const DisplayPoint& pos, size_t count, const ValueType* src)
+		{
+			ForEachSpanRow(pos, count, [&](size_t tgt, size_t x0, size_t x1, size_t done)
+			{
+				auto origin = Layout::ByteOrigin(x0);
+				buffer.resize(Layout::SpanLength(x0, x1));
+				//	範囲の両端のバイトに含まれる他のピクセルを保持するため、先に読み込む
+				if constexpr (Layout::IsPacked) { DIBLoaderHelper::Read(loader, (char*)buffer.data(), tgt + Layout::ByteOffset(x0), buffer.size()); }
+				for (auto x: Range<size_t>(x0, x1).GetStdIterator()) { Layout::Insert(buffer.data(), x - origin, src[done + (x - x0)]); }
+				loader.Write((const char*)buffer.data(), tgt + Layout::ByteOffset(x0), buffer.size());
+			});
+		}
+	private:
+		void CheckPos(const DisplayPoint& pos) const
+		{
+			if ( (pos.X() < 0)||(pos.Y() < 0)||(size.Width() <= pos.X())||(size.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
+		}
+		[[nodiscard]] size_t PixelOffset(const DisplayPoint& pos) const { return (stridelength * size_t(size.Height() - 1 - pos.Y())) + Layout::ByteOffset(size_t(pos.X())); }
+		///	ファイル上の並び順で連続する範囲を水平ラインごとに分割して @a func を呼び出します。
+		///	@a func は水平ラインの先頭の位置、水平ライン上の範囲 [x0, x1) 、およびそれまでに処理したピクセル数を受け取ります。
+		template<class F>
+		void ForEachSpanRow(const DisplayPoint& pos, size_t count, F&& func)
+		{
+			CheckPos(pos);
+			auto width = size_t(size.Width());
+			auto index = (size_t(size.Height() - 1 - pos.Y()) * width) + size_t(pos.X());
+			if ((width * size_t(size.Height()) - index) < count) { throw std::out_of_range("指定された範囲はこの画像領域を超えています。"); }
+			auto done = size_t(0U);
+			while (done < count)
+			{
+				auto row = (index + done) / width;
+				auto x0 = (index + done) % width;
+				auto x1 = std::min(width, x0 + (count - done));
+				func(offset + (stridelength * row), x0, x1, done);
+				done += x1 - x0;
+			}
+		}
+	};
+
+	///	Windows bitmap 画像の無圧縮のピクセル配列を、ビット幅を静的に指定してファイル上の並び順に書き込みます。
+	///	@param	Depth
+	///	各ピクセルのデータ長。
+	///	@note
+	///	@a DIBRGBEncoder と同様に、データはバッファに格納され、水平ライン単位でパディングを含めて書き込まれます。
+	template<DIBBitDepth Depth>
+	class DIBTypedEncoder final
+	{
+	public:
+		typedef DIBTypedLayout<Depth> Layout;
+		/// データの受け渡しに用いる型。
+		typedef typename Layout::ValueType ValueType;
+	private:
+		///	画像の大きさ。
+		DisplayRectSize size;
+		///	全体の要素数。
+		int64_t length;
+		///	現在の書き込み位置。
+		int64_t current;
+		///	書き込み待ちの水平ラインを格納するバッファ。
+		DIBRowBatch batch;
+	public:
+		///	@a DIBTypedEncoder を初期化します。
+		///	@param	loader
+		///	書き込みを行う @a DIBLoader 。
+		///	@param	offset
+		///	書き込み先のデータのオフセット。
+		///	@param	size
+		///	画像の大きさ。
+		///	@param	batchrows
+		///	1回の書き込みでまとめる水平ラインの数。
+		///	@exception	std::invalid_argument
+		///	@a batchrows に0が指定されました。
+		DIBTypedEncoder(DIBLoader& loader, size_t offset, const DisplayRectSize& size, size_t batchrows = 1U)
+			: size(size), length(int64_t(size.Width()) * size.Height()), current(0), batch(loader, offset, size, Layout::StrideLength(size.Width()), batchrows)
+		{}
+		DIBTypedEncoder(const DIBTypedEncoder&) = delete;
+		DIBTypedEncoder& operator=(const DIBTypedEncoder&) = delete;
+		///	書き込まれていないデータを書き込み、オブジェクトを破棄します。
+		///	書き込み中に発生した例外は無視されます。
+		~DIBTypedEncoder()
+		{
+			try { Flush(); }
+			catch (...) {}
+		}
+
+		///	現在の位置にピクセルを書き込み、現在の位置を次に進めます。
+		///	@exception	std::out_of_range
+		///	現在の位置はこの画像領域を超えています。
+		void Write(const ValueType& value)
+		{
+			if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
+			Layout::Insert(batch.Row(current), size_t(current % size.Width()), value);
+			++current;
+			batch.Advance(current);
+		}
+		///	現在の位置から1水平ライン分のピクセルを書き込み、現在の位置を次の水平ラインの先頭に進めます。
+		///	@param	row
+		///	書き込むピクセルデータ。
+		///	画像の幅の長さの領域が確保されている必要があります。
+		///	水平ラインはファイル上の並び順(画像の下から上)で書き込まれます。
+		///	@exception	InvalidOperationException
+		///	現在の位置が水平ラインの先頭ではありません。
+		void WriteRow(const ValueType* row)
+		{
+			if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
+			if ((current % size.Width()) != 0) { throw InvalidOperationException("現在の位置が水平ラインの先頭ではありません。"); }
+			auto dest = batch.Row(current);
+			for (auto x: Range<size_t>(0, size_t(size.Width())).GetStdIterator()) { Layout::Insert(dest, x, row[x]); }
+			current += size.Width();
+			batch.Advance(current);
+		}
+		///	バッファに格納されているデータを書き込みます。
+		///	書き込み途中の水平ラインはストライド全体が書き込まれ、未書き込みのピクセルは0になります。
+		void Flush() { batch.Flush(current); }
+		///	現在の位置が値を持っているかを取得します。
+		[[nodiscard]] bool HasValue() const { return (0 <= current)&&(current < length); }
+		///	現在の位置を画像上での位置で取得します。
+		[[nodiscard]] DisplayPoint CurrentPos() const { return DisplayPoint(current % size.Width(), size.Height() - 1 - (current / size.Width())); }
+	};
+
+	extern template class DIBTypedDecoder<DIBBitDepth::Bit1>;
+	extern template class DIBTypedDecoder<DIBBitDepth::Bit4>;
+	extern template class DIBTypedDecoder<DIBBitDepth::Bit8>;
+	extern template class DIBTypedDecoder<DIBBitDepth::Bit16>;
+	extern template class DIBTypedDecoder<DIBBitDepth::Bit24>;
+	extern template class DIBTypedDecoder<DIBBitDepth::Bit32>;
+	extern template class DIBTypedEncoder<DIBBitDepth::Bit1>;
+	extern template class DIBTypedEncoder<DIBBitDepth::Bit4>;
+	extern template class DIBTypedEncoder<DIBBitDepth::Bit8>;
+	extern template class DIBTypedEncoder<DIBBitDepth::Bit16>;
+	extern template class DIBTypedEncoder<DIBBitDepth::Bit24>;
+	extern template class DIBTypedEncoder<DIBBitDepth::Bit32>;
+}
+#endif // __stationaryorbit_graphics_dib_dibtypeddecoder__
@@ -24,6 +24,11 @@
 #include "dibheaders.hpp"
 #include "dibloader.hpp"
 #include "rgbdecoder.hpp"
+#include "dibbanddecoder.hpp"
+#include "dibbandencoder.hpp"
+#include "dibpixelcursor.hpp"
+#include "dibtilecache.hpp"
+#include "dibimageview.hpp"
 namespace zawa_ch::StationaryOrbit::Graphics::DIB
 {
 	///	@a DIBLoader を使用してV4Headerを持つWindows bitmap 画像を読み込みます。
@@ -33,10 +38,19 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		typedef uint32_t RawDataType;
 		typedef RGB8_t ValueType;
 		typedef RGB8Pixmap_t Pixmap;
+		typedef DIBRGBDecoder DecoderType;
+		typedef DIBPixelCursor<DIBV4Bitmap> PixelCursor;
+		typedef DIBImageView<DIBV4Bitmap> ImageView;
+		friend class DIBPixelCursor<DIBV4Bitmap>;
+		friend class DIBImageView<DIBV4Bitmap>;
 	private:
 		DIBLoader&& loader;
 		DIBV4Header ihead;
 		std::vector<RGB8_t> palette;
+		DIBBitFields bitfields;
+		DIBRowConverter converter;
+		size_t concurrency;
+		DIBTileCache tilecache;
 	public:
 		///	@a DIBLoader を使用して @a DIBV4Bitmap を初期化します。
 		///	@param	loader
@@ -51,7 +65,52 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] const DIBV4Header& InfoHead() const { return ihead; }
 		///	このオブジェクトの色パレットを取得します。
 		[[nodiscard]] std::optional<std::reference_wrapper<const std::vector<RGB8_t>>> Palette() const;
+		///	@a CopyTo および @a ToPixmap で使用するスレッド数を取得します。
+		[[nodiscard]] size_t DecodeConcurrency() const { return concurrency; }
+		///	@a CopyTo および @a ToPixmap で使用するスレッド数を設定します。
+		///	@param	threads
+		///	使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	既定値は 1 (呼び出し元のスレッドのみ)です。
+		///	@note
+		///	帯への分割と、呼び出し元のスレッドのみでデコードされる条件は @a DIBBandDecodeHelper::Decode を参照してください。
+		///	コピー先の画像バッファには異なる位置への書き込みが並行して行われます。
+		void SetDecodeConcurrency(size_t threads) { concurrency = threads; }
+		///	タイルのキャッシュの統計情報を取得します。
+		[[nodiscard]] const DIBTileCacheStatistics& TileCacheStatistics() const { return tilecache.Statistics(); }
+		///	デコードされたタイルのキャッシュの構成を変更します。
+		///	キャッシュされているタイルおよび統計情報は破棄されます。
+		///	@param	capacity
+		///	保持するタイルの合計の最大バイト数。 0 を指定した場合、キャッシュは無効になります。
+		///	既定ではキャッシュは無効です。
+		///	@param	tilesize
+		///	タイルの一辺の長さ(ピクセル単位)。
+		///	@note
+		///	キャッシュが有効な場合、 @a GetPixel(const DisplayPoint&) 、 @a CopyTo(WritableImage<RGB8_t>&, const DisplayRectangle&, const DisplayPoint&) および @a ToPixmap(const DisplayRectangle&) はキャッシュされたタイルから色を取得します。
+		///	このオブジェクトを経由した書き込みでは、書き込んだ位置を含むタイルが破棄されます。
+		void SetTileCache(size_t capacity, int32_t tilesize = DIBTileCache::DefaultTileSize);
+		///	キャッシュされているタイルを破棄します。
+		///	@a DIBLoader を直接使用してピクセル配列を書き換えた場合に使用します。
+		void ClearTileCache() noexcept { tilecache.Clear(); }
+		///	タイルのキャッシュの統計情報をリセットします。
+		void ResetTileCacheStatistics() noexcept { tilecache.ResetStatistics(); }
 
+		///	画像の任意の位置のピクセルを繰り返し読み書きするための @a PixelCursor を取得します。
+		///	@note
+		///	@a PixelCursor は画像の情報を保持し、ピクセルデータは要求された時点でのみ読み込みます。
+		///	多数の位置を参照する場合は、 @a GetPixel を繰り返し呼び出す代わりに1つの @a PixelCursor を使い回してください。
+		///	@exception	NotImplementedException
+		///	現在のComplessionMethodでのピクセル単位の読み書きは実装されていません。
+		[[nodiscard]] PixelCursor Cursor();
+		///	このビットマップを @a Image<RGB8_t> として参照する @a ImageView を取得します。
+		///	@param	rowcount
+		///	@a ImageView が保持する水平ラインの数。
+		///	@note
+		///	@a ImageView は要求された水平ラインのみをデコードするため、 @a ToPixmap で画像全体を展開せずに画像を受け取る処理へ渡すことができます。
+		///	このビットマップへの書き込みは、 @a ImageView が保持している水平ラインには反映されません。
+		///	@a ImageView を @a Generate や @a DIBScanlineWriter::WriteImage に渡す場合、スレッド数には1を指定する必要があります。
+		///	@exception	NotImplementedException
+		///	現在のComplessionMethodでのデコードは実装されていません。
+		[[nodiscard]] ImageView View(int32_t rowcount = ImageView::DefaultRowCount);
 		///	画像の指定された位置にある1ピクセルの色を取得します。
 		///	@param	pos
 		///	取得する画像上の座標位置。
@@ -124,7 +183,13 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	生成時に格納する画像ヘッダデータ。
 		///	@param	image
 		///	生成時に格納する画像データ。
-		static std::optional<DIBV4Bitmap> Generate(DIBLoader&& loader, const DIBV4Header& header, const Image<RGB8_t>& image);
+		///	@param	concurrency
+		///	画像データの変換に使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@return
+		///	書き込んだデータを参照する @a DIBV4Bitmap 。
+		///	@a loader が読み込みに対応していない場合( @a DIBOutputStreamLoader など)は、書き込みのみを行い @a std::nullopt を返します。
+		///	書き込んだデータをビットマップとして読み込めなかった場合も @a std::nullopt を返します。
+		static std::optional<DIBV4Bitmap> Generate(DIBLoader&& loader, const DIBV4Header& header, const Image<RGB8_t>& image, size_t concurrency = 1);
 		///	指定された @a DIBLoader に画像データを書き込み、 @a DIBV4Bitmap を生成します。
 		///	@param	loader
 		///	書き込み先の @a DIBLoader オブジェクト。
@@ -135,12 +200,20 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	生成時に格納する色パレット。
 		///	@param	image
 		///	生成時に格納する画像データ。
-		static std::optional<DIBV4Bitmap> Generate(DIBLoader&& loader, const DIBV4Header& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image);
+		///	@param	concurrency
+		///	画像データの変換に使用するスレッド数。 0 の場合、ハードウェアがサポートするスレッド数を使用します。
+		///	@return
+		///	書き込んだデータを参照する @a DIBV4Bitmap 。
+		///	@a loader が読み込みに対応していない場合( @a DIBOutputStreamLoader など)は、書き込みのみを行い @a std::nullopt を返します。
+		///	書き込んだデータをビットマップとして読み込めなかった場合も @a std::nullopt を返します。
+		static std::optional<DIBV4Bitmap> Generate(DIBLoader&& loader, const DIBV4Header& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image, size_t concurrency = 1);
 	private:
+		void DecodeRegion(const DisplayRectangle& area, RGB8_t* dest);
+		void InvalidateTiles(const DisplayRectangle& area) noexcept { tilecache.Invalidate(area); }
 		[[nodiscard]] ValueType ConvertToRGB(const DIBRGBDecoder::ValueType& data) const;
 		[[nodiscard]] RawDataType ConvertToRawData(const DIBRGBDecoder::ValueType& data) const;
-		[[nodiscard]] DIBRGBDecoder::ValueType ConvertToRGBDecoderValue(const ValueType& value) const;
-		[[nodiscard]] DIBRGBDecoder::ValueType ConvertToRGBDecoderValue(const RawDataType& value) const;
+		[[nodiscard]] DIBRGBDecoder::ValueType ConvertToDecoderValue(const ValueType& value) const;
+		[[nodiscard]] DIBRGBDecoder::ValueType ConvertToDecoderValue(const RawDataType& value) const;
 	};
 }
 #endif // __stationeryorbit_graphics_dib_dibv4bitmap__
@@ -19,8 +19,12 @@
 #ifndef __stationaryorbit_graphics_dib_rgbdecoder__
 #define __stationaryorbit_graphics_dib_rgbdecoder__
 #include <variant>
+#include <optional>
 #include "stationaryorbit/core.iteration.hpp"
 #include "dibloader.hpp"
+#include "dibrowconverter.hpp"
+#include "dibrowbatch.hpp"
+#include "dibtypeddecoder.hpp"
 namespace zawa_ch::StationaryOrbit::Graphics::DIB
 {
 	///	Windows bitmap 画像のデータを無圧縮RGBデータとして読み取ります。
@@ -41,13 +45,18 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	現在の読み込み位置。
 		int64_t current;
 		///	現在の値。
-		ValueType current_value;
+		///	@a Current() で最初に要求されるまで読み込まれません。
+		mutable std::optional<ValueType> current_value;
 		///	各ピクセルのデータ長。
 		DIBBitDepth bitdepth;
 		///	1ピクセルのデータ長(バイト単位)。
 		const size_t pixellength;
 		///	ストライド(1水平軸ラインのデータ長)。
 		const size_t stridelength;
+		///	1水平軸ラインのパディングを含まないデータ長。
+		const size_t rowlength;
+		///	水平ライン単位の読み込みに使用するバッファ。
+		std::vector<uint8_t> rowbuffer;
 	public:
 		DIBRGBDecoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size);
 		virtual ~DIBRGBDecoder() = default;
@@ -75,6 +84,8 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		///	現在の位置を画像上での位置で取得します。
 		[[nodiscard]] DisplayPoint CurrentPos() const;
 		///	現在の位置にあるオブジェクトを取得します。
+		///	@note
+		///	値は最初に要求された時点で読み込まれ、位置を移動するまで保持されます。
 		[[nodiscard]] ValueType Current() const;
 		///	現在の位置にオブジェクトを書き込みます。
 		void Write(const ValueType& value);
@@ -82,12 +93,116 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] IteratorTraits::IteratorDiff_t Distance(const DIBRGBDecoder& other) const;
 		[[nodiscard]] bool Equals(const DIBRGBDecoder& other) const;
 		[[nodiscard]] int Compare(const DIBRGBDecoder& other) const;
+		///	1水平軸ラインのデータ長(バイト単位)を取得します。
+		[[nodiscard]] size_t StrideLength() const { return stridelength; }
+		///	各ピクセルのデータ長を取得します。
+		[[nodiscard]] DIBBitDepth BitDepth() const { return bitdepth; }
+		///	このオブジェクトと同じピクセル配列を読み書きする、ビット幅を静的に指定したデコーダーを取得します。
+		///	@exception	InvalidOperationException
+		///	@a Depth がこのオブジェクトの各ピクセルのデータ長と一致しません。
+		template<DIBBitDepth Depth>
+		[[nodiscard]] DIBTypedDecoder<Depth> Typed() const
+		{
+			if (Depth != bitdepth) { throw InvalidOperationException("指定されたビット幅がこのオブジェクトと一致しません。"); }
+			return DIBTypedDecoder<Depth>(loader, offset, size);
+		}
+		///	指定された水平ラインの生データを1回の読み込みで取得します。
+		///	@param	y
+		///	読み込む水平ラインの画像上のY座標。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a StrideLength() の長さの領域が確保されている必要があります。
+		///	ストライド末尾のパディングは読み込まれません。
+		void ReadRow(int32_t y, uint8_t* dest);
+		///	指定された範囲の水平ラインの生データを1回の読み込みで取得します。
+		///	@param	y0
+		///	読み込む範囲の先頭の水平ラインの画像上のY座標。
+		///	@param	y1
+		///	読み込む範囲の末尾の次の水平ラインの画像上のY座標。
+		///	@param	dest
+		///	読み込んだデータの格納先。
+		///	@a StrideLength()*(y1-y0) の長さの領域が確保されている必要があります。
+		///	データはファイル上の並び順(画像の下から上)で格納されます。
+		///	最後の水平ラインのパディングは読み込まれません。
+		void ReadRows(int32_t y0, int32_t y1, uint8_t* dest);
+		///	指定された水平ラインを読み込み、色に変換します。
+		///	@param	y
+		///	読み込む水平ラインの画像上のY座標。
+		///	@param	dest
+		///	変換した色の格納先。
+		///	画像の幅の長さの領域が確保されている必要があります。
+		///	@param	converter
+		///	変換に使用する @a DIBRowConverter 。
+		void DecodeRow(int32_t y, RGB8_t* dest, const DIBRowConverter& converter);
+		///	指定された範囲の水平ラインを1回の読み込みで取得し、色に変換します。
+		///	@param	y0
+		///	読み込む範囲の先頭の水平ラインの画像上のY座標。
+		///	@param	y1
+		///	読み込む範囲の末尾の次の水平ラインの画像上のY座標。
+		///	@param	dest
+		///	変換した色の格納先。
+		///	画像の幅*(y1-y0) の長さの領域が確保されている必要があります。
+		///	色は画像上の並び順(画像の上から下)で格納されます。
+		///	@param	converter
+		///	変換に使用する @a DIBRowConverter 。
+		void DecodeRows(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter);
+		///	指定された矩形領域のピクセルを読み込み、色に変換します。
+		///	@param	area
+		///	読み込む領域。
+		///	@param	dest
+		///	変換した色の格納先。
+		///	@a area の幅*高さ の長さの領域が確保されている必要があります。
+		///	色は画像上の並び順(画像の上から下)で格納されます。
+		///	@param	converter
+		///	変換に使用する @a DIBRowConverter 。
+		///	@note
+		///	各水平ラインについて、領域に含まれるピクセルのデータのみを1回の読み込みで取得します。
+		///	@exception	std::out_of_range
+		///	指定された領域はこの画像領域を超えています。
+		void DecodeRegion(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter);
+		///	指定された領域がこの画像領域に収まっているかを検証します。
+		///	検証した領域の内側では、 @a ReadRowsUnchecked 、 @a DecodeRowsUnchecked および @a GetUnchecked を範囲の検査なしで使用できます。
+		///	@exception	std::out_of_range
+		///	指定された領域はこの画像領域を超えています。
+		void ValidateRegion(const DisplayRectangle& area) const;
+		///	範囲の検査を行わずに、指定された範囲の水平ラインの生データを1回の読み込みで取得します。
+		///	@note
+		///	[y0, y1) は @a ValidateRegion で検証した領域に含まれている必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		///	引数と格納先は @a ReadRows と同じです。
+		void ReadRowsUnchecked(int32_t y0, int32_t y1, uint8_t* dest);
+		///	範囲の検査を行わずに、指定された範囲の水平ラインを1回の読み込みで取得し、色に変換します。
+		///	@note
+		///	[y0, y1) は @a ValidateRegion で検証した領域に含まれている必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		///	引数と格納先は @a DecodeRows と同じです。
+		void DecodeRowsUnchecked(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter);
+		///	範囲の検査を行わずに、指定された位置のピクセルを読み込みます。
+		///	現在の位置と保持している値は変更されません。
+		///	@note
+		///	@a pos は @a ValidateRegion で検証した領域に含まれている必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		[[nodiscard]] ValueType GetUnchecked(const DisplayPoint& pos) const;
+		///	範囲の検査を行わずに、指定された矩形領域のピクセルを読み込み、色に変換します。
+		///	@note
+		///	@a area は @a ValidateRegion で検証した領域である必要があります。
+		///	範囲外を指定した場合の動作は未定義です。
+		///	引数と格納先は @a DecodeRegion と同じです。
+		void DecodeRegionUnchecked(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter);
 	private:
-		[[nodiscard]] ValueType Get(size_t index);
+		///	指定した範囲のデータを取得します。
+		///	ローダーが @a DIBLoader::Peek で直接参照できる場合はその領域を、それ以外の場合は @a rowbuffer に読み込んだ領域を返します。
+		///	返された領域は次にこのオブジェクトで読み込みを行うまで有効です。
+		[[nodiscard]] const uint8_t* FetchBytes(size_t pos, size_t length);
+		///	@note
+		///	@a index は画像の範囲内である必要があります。範囲の検査は呼び出し元で行います。
+		[[nodiscard]] ValueType Get(size_t index) const;
 		[[nodiscard]] size_t ResolveIndex(const DisplayPoint& pos) const;
 		[[nodiscard]] DisplayPoint ResolvePos(size_t index) const;
 		[[nodiscard]] size_t ResolveOffset(const DisplayPoint& pos) const;
 		[[nodiscard]] size_t ResolveOffset(size_t index) const;
+		[[nodiscard]] uint32_t ExtractPacked(uint8_t data, size_t index) const;
+		[[nodiscard]] uint8_t InsertPacked(uint8_t data, uint32_t value, size_t index) const;
 	};
 	///	Windows bitmap 画像のデータを無圧縮RGBデータとして書き込みます。
 	class DIBRGBEncoder
@@ -96,10 +211,6 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		/// データの受け渡しに用いる型。
 		typedef std::variant<DIBPixelData<DIBBitDepth::Bit1>, DIBPixelData<DIBBitDepth::Bit4>, DIBPixelData<DIBBitDepth::Bit8>, DIBPixelData<DIBBitDepth::Bit16>, DIBPixelData<DIBBitDepth::Bit24>, DIBPixelData<DIBBitDepth::Bit32>> ValueType;
 	private:
-		///	書き込みを行う @a DIBLoader への参照。
-		DIBLoader& loader;
-		///	書き込み先のデータのオフセット。
-		size_t offset;
 		///	画像の大きさ。
 		DisplayRectSize size;
 		///	全体の要素数。
@@ -112,13 +223,48 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		const size_t pixellength;
 		///	ストライド(1水平軸ラインのデータ長)。
 		const size_t stridelength;
+		///	書き込み待ちの水平ラインを格納するバッファ。
+		DIBRowBatch batch;
 	public:
-		DIBRGBEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size);
-		virtual ~DIBRGBEncoder() = default;
+		///	@a DIBRGBEncoder を初期化します。
+		///	@param	loader
+		///	書き込みを行う @a DIBLoader 。
+		///	@param	offset
+		///	書き込み先のデータのオフセット。
+		///	@param	bitdepth
+		///	各ピクセルのデータ長。
+		///	@param	size
+		///	画像の大きさ。
+		///	@param	batchrows
+		///	1回の書き込みでまとめる水平ラインの数。
+		///	@exception	std::invalid_argument
+		///	@a batchrows に0が指定されました。
+		DIBRGBEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size, size_t batchrows = 1U);
+		///	書き込まれていないデータを書き込み、オブジェクトを破棄します。
+		///	書き込み中に発生した例外は無視されます。
+		virtual ~DIBRGBEncoder();
 
 		///	現在の位置にオブジェクトを書き込み、現在の位置を次に進めます。
+		///	@note
+		///	データはバッファに格納され、 @a batchrows 分の水平ラインが揃うか画像の末尾に達した時点でパディングを含めて1回で書き込まれます。
 		void Write(const ValueType& value);
+		///	現在の位置から1水平ライン分の色を書き込み、現在の位置を次の水平ラインの先頭に進めます。
+		///	@param	row
+		///	書き込む色。
+		///	画像の幅の長さの領域が確保されている必要があります。
+		///	水平ラインはファイル上の並び順(画像の下から上)で書き込まれるため、 @a CurrentPos().Y() の水平ラインの色を渡す必要があります。
+		///	@param	packer
+		///	色をピクセルデータに変換する @a DIBRowConverter 。
+		///	@exception	InvalidOperationException
+		///	現在の位置が水平ラインの先頭ではありません。
+		///	@exception	std::invalid_argument
+		///	@a packer の各ピクセルのデータ長がこのオブジェクトと一致しません。
+		void WriteRow(const RGB8_t* row, const DIBRowConverter& packer);
+		///	バッファに格納されているデータを書き込みます。
+		///	書き込み途中の水平ラインはストライド全体が書き込まれ、未書き込みのピクセルは0になります。
+		void Flush();
 		///	現在の位置を初期位置に戻します。
+		///	バッファに格納されているデータは先に書き込まれます。
 		void Reset();
 		///	現在の位置が値を持っているかを取得します。
 		[[nodiscard]] bool HasValue() const;
@@ -128,6 +274,7 @@ namespace zawa_ch::StationaryOrbit::Graphics::DIB
 		[[nodiscard]] int Compare(const DIBRGBEncoder& other) const;
 
 		[[nodiscard]] static size_t GetPxLength(DIBBitDepth bitdepth);
+		[[nodiscard]] static size_t GetRowLength(DIBBitDepth bitdepth, const DisplayRectSize& size);
 		[[nodiscard]] static size_t GetStrideLength(DIBBitDepth bitdepth, const DisplayRectSize& size);
 		[[nodiscard]] static size_t GetImageLength(DIBBitDepth bitdepth, const DisplayRectSize& size);
 	private:
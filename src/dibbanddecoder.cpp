@@ -0,0 +1,95 @@
+//	stationaryorbit.graphics-dib:/dibbanddecoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include "stationaryorbit/graphics-dib/dibbanddecoder.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+size_t DIBBandDecodeHelper::ResolveThreadCount(size_t threads, size_t bands)
+{
+	if (threads == 0) { threads = std::thread::hardware_concurrency(); }
+	return std::max<size_t>(1U, std::min(threads, bands));
+}
+size_t DIBBandDecodeHelper::Decode(DIBLoader& loader, int32_t width, int32_t top, int32_t bottom, size_t threads, const BandFunction& decode, const RowFunction& sink)
+{
+	if ((width <= 0)||(bottom <= top)) { return 1U; }
+	auto bands = size_t((bottom - top + BandHeight - 1) / BandHeight);
+	auto workers = ResolveThreadCount(threads, bands);
+	//	読み込みはスレッドを起動する前に呼び出し元のスレッドで構築する
+	auto readers = std::vector<std::unique_ptr<DIBLoader>>();
+	while ((1U < workers)&&(readers.size() < workers))
+	{
+		auto reader = loader.CreateReader();
+		if (reader == nullptr) { break; }
+		readers.push_back(std::move(reader));
+	}
+	if ((workers <= 1U)||(readers.size() < workers))
+	{
+		//	独立した読み込みが使用できないため、呼び出し元のスレッドでデコードする
+		auto buffer = std::vector<RGB8_t>(size_t(width) * BandHeight);
+		for (auto y0 = top; y0 < bottom; y0 += BandHeight)
+		{
+			auto y1 = std::min(bottom, y0 + BandHeight);
+			decode(loader, y0, y1, buffer.data());
+			for (auto y: Range<int32_t>(y0, y1).GetStdIterator()) { sink(y, buffer.data() + (size_t(width) * (y - y0))); }
+		}
+		return 1U;
+	}
+	auto next = std::atomic<size_t>(0U);
+	auto failed = std::atomic<bool>(false);
+	auto error = std::exception_ptr();
+	auto errorlock = std::mutex();
+	auto work = [&](DIBLoader& reader)
+	{
+		auto buffer = std::vector<RGB8_t>(size_t(width) * BandHeight);
+		try
+		{
+			for (auto band = next++; (band < bands)&&(!failed); band = next++)
+			{
+				auto y0 = top + int32_t(band * BandHeight);
+				auto y1 = std::min(bottom, y0 + BandHeight);
+				decode(reader, y0, y1, buffer.data());
+				for (auto y: Range<int32_t>(y0, y1).GetStdIterator()) { sink(y, buffer.data() + (size_t(width) * (y - y0))); }
+			}
+		}
+		catch (...)
+		{
+			auto lock = std::lock_guard<std::mutex>(errorlock);
+			if (!failed) { error = std::current_exception(); failed = true; }
+		}
+	};
+	auto pool = std::vector<std::thread>();
+	pool.reserve(workers - 1);
+	for (auto i: Range<size_t>(1, workers).GetStdIterator())
+	{
+		//	スレッドを起動できない場合は、起動できたスレッドのみで残りの帯を処理する
+		try { pool.emplace_back(work, std::ref(*readers[i])); }
+		catch (const std::system_error&) { break; }
+	}
+	//	呼び出し元のスレッドもワーカーの1つとして動作する
+	work(*readers[0]);
+	for (auto& thread: pool) { thread.join(); }
+	if (error) { std::rethrow_exception(error); }
+	return pool.size() + 1U;
+}
@@ -0,0 +1,117 @@
+//	stationaryorbit.graphics-dib:/dibbandencoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <stdexcept>
+#include "stationaryorbit/graphics-dib/dibbandencoder.hpp"
+#include "stationaryorbit/graphics-dib/dibbanddecoder.hpp"
+#include "stationaryorbit/graphics-dib/rgbdecoder.hpp"
+#include "stationaryorbit/graphics-dib/dibimageview.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+void DIBBandEncodeHelper::Encode(DIBLoader& loader, size_t offset, const DisplayRectSize& size, const DIBRowConverter& packer, const Image<RGB8_t>& image, size_t threads)
+{
+	//	ビューは直近の水平ラインのみを保持するため、帯ごとに異なる水平ラインを並行して参照するとデコードが繰り返される
+	if ((threads != 1U)&&(dynamic_cast<const DIBImageViewBase*>(&image) != nullptr)) { throw std::invalid_argument("DIBImageViewを複数のスレッドで書き込むことはできません。"); }
+	if ((size.Width() <= 0)||(size.Height() <= 0)) { return; }
+	auto width = size.Width();
+	auto height = size.Height();
+	auto stridelength = DIBRGBEncoder::GetStrideLength(packer.BitDepth(), size);
+	auto rowlength = DIBRGBEncoder::GetRowLength(packer.BitDepth(), size);
+	auto bands = size_t((height + BandHeight - 1) / BandHeight);
+	auto workers = DIBBandDecodeHelper::ResolveThreadCount(threads, bands);
+	//	帯はファイル上の並び順(画像の下から上)に番号を振る
+	//	帯の中の水平ラインもファイル上の並び順で格納し、パディングを含めて1回で書き込む
+	auto convert = [&](size_t band, std::vector<RGB8_t>& row, std::vector<uint8_t>& buffer) -> std::pair<size_t, size_t>
+	{
+		auto y1 = height - int32_t(band * BandHeight);
+		auto y0 = std::max(0, y1 - BandHeight);
+		for (auto i: Range<int32_t>(0, y1 - y0).GetStdIterator())
+		{
+			auto y = y1 - 1 - i;
+			for (auto x: Range<int32_t>(0, width).GetStdIterator()) { row[x] = image.At(DisplayPoint(x, y)); }
+			auto dest = buffer.data() + (stridelength * i);
+			packer.Pack(row.data(), dest, width);
+			std::fill(dest + rowlength, dest + stridelength, uint8_t());
+		}
+		return std::make_pair(offset + (stridelength * (height - y1)), stridelength * (y1 - y0));
+	};
+	if (workers <= 1U)
+	{
+		//	呼び出し元のスレッドのみで変換する場合は、帯の単位でまとめて書き込むエンコーダを使用する
+		auto encoder = DIBRGBEncoder(loader, offset, packer.BitDepth(), size, BandHeight);
+		auto row = std::vector<RGB8_t>(width);
+		while (encoder.HasValue())
+		{
+			auto y = encoder.CurrentPos().Y();
+			for (auto x: Range<int32_t>(0, width).GetStdIterator()) { row[x] = image.At(DisplayPoint(x, y)); }
+			encoder.WriteRow(row.data(), packer);
+		}
+		return;
+	}
+	auto next = std::atomic<size_t>(0U);
+	auto written = size_t(0U);
+	auto failed = false;
+	auto error = std::exception_ptr();
+	auto lock = std::mutex();
+	auto turn = std::condition_variable();
+	auto work = [&]()
+	{
+		auto row = std::vector<RGB8_t>(width);
+		auto buffer = std::vector<uint8_t>(stridelength * BandHeight);
+		try
+		{
+			for (auto band = next++; band < bands; band = next++)
+			{
+				auto [pos, length] = convert(band, row, buffer);
+				//	書き込みは帯の順に行い、 @a DIBLoader へのアクセスを直列化する
+				auto guard = std::unique_lock<std::mutex>(lock);
+				turn.wait(guard, [&]() { return failed || (written == band); });
+				if (failed) { return; }
+				loader.Write((const char*)buffer.data(), pos, length);
+				++written;
+				turn.notify_all();
+			}
+		}
+		catch (...)
+		{
+			auto guard = std::lock_guard<std::mutex>(lock);
+			if (!failed) { error = std::current_exception(); failed = true; }
+			turn.notify_all();
+		}
+	};
+	auto pool = std::vector<std::thread>();
+	pool.reserve(workers - 1);
+	while (pool.size() < (workers - 1))
+	{
+		//	スレッドを起動できない場合は、起動できたスレッドのみで残りの帯を処理する
+		try { pool.emplace_back(work); }
+		catch (const std::system_error&) { break; }
+	}
+	//	呼び出し元のスレッドもワーカーの1つとして動作する
+	work();
+	for (auto& thread: pool) { thread.join(); }
+	if (error) { std::rethrow_exception(error); }
+}
@@ -0,0 +1,45 @@
+//	stationaryorbit.graphics-dib:/dibbitfields
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include "stationaryorbit/graphics-dib/dibbitfields.hpp"
+#include "stationaryorbit/graphics-dib/invaliddibformat.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+DIBChannelBitField::DIBChannelBitField(uint32_t mask) : DIBChannelBitField()
+{
+	if (mask == 0) { return; }
+	Mask = mask;
+	while (((mask >> Shift) & 1U) == 0) { ++Shift; }
+	while ((Shift + Width < 32)&&(((mask >> (Shift + Width)) & 1U) != 0)) { ++Width; }
+	if ((mask >> Shift) != ((Width < 32)?((1U << Width) - 1):(~uint32_t()))) { throw InvalidDIBFormatException("色マスクのビットが連続していません。"); }
+	Reduce = (8 < Width)?(Width - 8):(0);
+	//	上位ビットを繰り返し下位に複製した値の倍率を求める
+	//	ビット幅が8以上の場合は 1.0 となる
+	auto bits = int(Width - Reduce);
+	for (auto shift = 8 - bits; -bits < shift; shift -= bits) { Scale += uint32_t(1) << (16 + shift); }
+}
+
+DIBBitFields::DIBBitFields() : red(), green(), blue(), alpha(), layout(Layouts::Generic) {}
+DIBBitFields::DIBBitFields(const DIBRGBColorMask& mask) : DIBBitFields(DIBRGBAColorMask{ mask.RedMask, mask.GreenMask, mask.BlueMask, 0 }) {}
+DIBBitFields::DIBBitFields(const DIBRGBAColorMask& mask) : red(mask.RedMask), green(mask.GreenMask), blue(mask.BlueMask), alpha(mask.AlphaMask), layout(Layouts::Generic)
+{
+	if ((mask.RedMask == 0x7C00)&&(mask.GreenMask == 0x03E0)&&(mask.BlueMask == 0x001F)) { layout = Layouts::RGB555; }
+	else if ((mask.RedMask == 0xF800)&&(mask.GreenMask == 0x07E0)&&(mask.BlueMask == 0x001F)) { layout = Layouts::RGB565; }
+	else if ((mask.RedMask == 0x00FF0000)&&(mask.GreenMask == 0x0000FF00)&&(mask.BlueMask == 0x000000FF)) { layout = Layouts::XRGB8888; }
+}
@@ -21,7 +21,7 @@ using namespace zawa_ch::StationaryOrbit;
 using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
 
 DIBCoreBitmapDecoder::DIBCoreBitmapDecoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size)
-	: loader(loader), offset(offset), bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), pixellength(DIBCoreBitmapEncoder::GetPxLength(bitdepth)), stridelength(DIBCoreBitmapEncoder::GetStrideLength(bitdepth, size))
+	: loader(loader), offset(offset), bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), pixellength(DIBCoreBitmapEncoder::GetPxLength(bitdepth)), stridelength(DIBCoreBitmapEncoder::GetStrideLength(bitdepth, size)), rowlength(DIBCoreBitmapEncoder::GetRowLength(bitdepth, size))
 {
 	Reset();
 }
@@ -30,7 +30,7 @@ bool DIBCoreBitmapDecoder::Next()
 	if (IsAfterEnd()) { return false; }
 	++current;
 	if (IsAfterEnd()) { current = length; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 bool DIBCoreBitmapDecoder::Next(const IteratorTraits::IteratorDiff_t& count)
@@ -38,7 +38,7 @@ bool DIBCoreBitmapDecoder::Next(const IteratorTraits::IteratorDiff_t& count)
 	if (IsAfterEnd()) { return false; }
 	current += count;
 	if (IsAfterEnd()) { current = length; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 bool DIBCoreBitmapDecoder::Previous()
@@ -46,7 +46,7 @@ bool DIBCoreBitmapDecoder::Previous()
 	if (IsBeforeBegin()) { return false; }
 	--current;
 	if (IsBeforeBegin()) { current = -1; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 bool DIBCoreBitmapDecoder::Previous(const IteratorTraits::IteratorDiff_t& count)
@@ -54,14 +54,15 @@ bool DIBCoreBitmapDecoder::Previous(const IteratorTraits::IteratorDiff_t& count)
 	if (IsBeforeBegin()) { return false; }
 	current -= count;
 	if (IsBeforeBegin()) { current = -1; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 void DIBCoreBitmapDecoder::JumpTo(const DisplayPoint& pos)
 {
 	if ( (pos.X() < 0)||(pos.Y() < 0) ) { throw std::invalid_argument("posに指定されている座標が無効です。"); }
+	if ( (size.Width() <= pos.X())||(size.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
 	current = ResolveIndex(pos);
-	current_value = Get(ResolveIndex(pos));
+	current_value.reset();
 }
 void DIBCoreBitmapDecoder::Reset() { Reset(IteratorOrigin::Begin); }
 void DIBCoreBitmapDecoder::Reset(const IteratorOrigin& origin)
@@ -72,20 +73,33 @@ void DIBCoreBitmapDecoder::Reset(const IteratorOrigin& origin)
 		case IteratorOrigin::Begin: { current = 0; break; }
 		case IteratorOrigin::End: { current = length - 1; break; }
 	}
-	current_value = Get(current);
+	current_value.reset();
 }
 bool DIBCoreBitmapDecoder::HasValue() const { return (0 <= current)&&(current < length); }
 bool DIBCoreBitmapDecoder::IsBeforeBegin() const { return current < 0; }
 bool DIBCoreBitmapDecoder::IsAfterEnd() const { return length <= current; }
 Graphics::DisplayPoint DIBCoreBitmapDecoder::CurrentPos() const { return ResolvePos(current); }
-DIBCoreBitmapDecoder::ValueType DIBCoreBitmapDecoder::Current() const { if (HasValue()) { return current_value; } else { throw InvalidOperationException("このイテレータは領域の範囲外を指しています。"); } }
+DIBCoreBitmapDecoder::ValueType DIBCoreBitmapDecoder::Current() const
+{
+	if (!HasValue()) { throw InvalidOperationException("このイテレータは領域の範囲外を指しています。"); }
+	if (!current_value.has_value()) { current_value = Get(current); }
+	return *current_value;
+}
 void DIBCoreBitmapDecoder::Write(const ValueType& value)
 {
+	if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
 	size_t tgt = offset + ResolveOffset(current);
 	switch(bitdepth)
 	{
-		case DIBBitDepth::Bit1: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit1>>(value), tgt); break; }
-		case DIBBitDepth::Bit4: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit4>>(value), tgt); break; }
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		{
+			//	同じバイトに含まれる他のピクセルを保持して書き込む
+			auto data = uint8_t();
+			DIBLoaderHelper::Read(loader, data, tgt);
+			DIBLoaderHelper::Write(loader, InsertPacked(data, std::visit([](auto i)->uint32_t { return uint32_t(i); }, value), current), tgt);
+			break;
+		}
 		case DIBBitDepth::Bit8: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit8>>(value), tgt); break; }
 		case DIBBitDepth::Bit24: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit24>>(value), tgt); break; }
 		default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
@@ -100,22 +114,105 @@ int DIBCoreBitmapDecoder::Compare(const DIBCoreBitmapDecoder& other) const
 	else if (other.current < current) { return 1; }
 	else { return -1; }
 }
-DIBCoreBitmapDecoder::ValueType DIBCoreBitmapDecoder::Get(size_t index)
+void DIBCoreBitmapDecoder::ReadRow(int32_t y, uint8_t* dest)
+{
+	if ( (y < 0)||(size.Height() <= y) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
+	//	ストライド末尾のパディングは読み込まない
+	DIBLoaderHelper::Read(loader, (char*)dest, offset + (stridelength * (size.Height() - 1 - y)), rowlength);
+}
+void DIBCoreBitmapDecoder::ReadRows(int32_t y0, int32_t y1, uint8_t* dest)
+{
+	if ( (y0 < 0)||(y1 < y0)||(size.Height() < y1) ) { throw std::out_of_range("指定された範囲はこの画像領域を超えています。"); }
+	ReadRowsUnchecked(y0, y1, dest);
+}
+void DIBCoreBitmapDecoder::DecodeRow(int32_t y, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if ( (y < 0)||(size.Height() <= y) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
+	converter.Convert(FetchBytes(offset + (stridelength * (size.Height() - 1 - y)), rowlength), dest, size.Width());
+}
+void DIBCoreBitmapDecoder::DecodeRows(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if ( (y0 < 0)||(y1 < y0)||(size.Height() < y1) ) { throw std::out_of_range("指定された範囲はこの画像領域を超えています。"); }
+	DecodeRowsUnchecked(y0, y1, dest, converter);
+}
+void DIBCoreBitmapDecoder::DecodeRegion(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	ValidateRegion(area);
+	DecodeRegionUnchecked(area, dest, converter);
+}
+void DIBCoreBitmapDecoder::ValidateRegion(const DisplayRectangle& area) const
+{
+	if ( (area.Left() < 0)||(area.Top() < 0)||(area.Right() < area.Left())||(area.Bottom() < area.Top()) ) { throw std::out_of_range("指定された領域はこの画像領域を超えています。"); }
+	if ( (size.Width() < area.Right())||(size.Height() < area.Bottom()) ) { throw std::out_of_range("指定された領域はこの画像領域を超えています。"); }
+}
+void DIBCoreBitmapDecoder::ReadRowsUnchecked(int32_t y0, int32_t y1, uint8_t* dest)
+{
+	if (y0 == y1) { return; }
+	DIBLoaderHelper::Read(loader, (char*)dest, offset + (stridelength * (size.Height() - y1)), (stridelength * (y1 - y0 - 1)) + rowlength);
+}
+void DIBCoreBitmapDecoder::DecodeRowsUnchecked(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if (y0 == y1) { return; }
+	auto source = FetchBytes(offset + (stridelength * (size.Height() - y1)), (stridelength * (y1 - y0 - 1)) + rowlength);
+	//	ファイル上の並びは画像の下から上であるため、逆順に変換する
+	for (auto i: Range<int32_t>(0, y1 - y0).GetStdIterator())
+	{
+		converter.Convert(source + (stridelength * i), dest + (size_t(size.Width()) * (y1 - y0 - 1 - i)), size.Width());
+	}
+}
+void DIBCoreBitmapDecoder::DecodeRegionUnchecked(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if ( (area.Width() <= 0)||(area.Height() <= 0) ) { return; }
+	auto bits = size_t(uint16_t(bitdepth));
+	if (bits == 0) { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
+	auto x0 = size_t(area.Left());
+	auto x1 = size_t(area.Right());
+	//	領域の左端のピクセルを含むバイトから、右端のピクセルを含むバイトまでを読み込む
+	auto first = (bits * x0) / 8;
+	auto length = (((bits * x1) + 7) / 8) - first;
+	//	1バイトに複数のピクセルを格納する場合、バイトの先頭のピクセルから変換して左端の余分なピクセルを読み飛ばす
+	auto origin = (first * 8) / bits;
+	auto skip = x0 - origin;
+	auto count = x1 - origin;
+	auto colors = std::vector<RGB8_t>((skip != 0)?(count):(0));
+	for (auto y: Range<int32_t>(area.Top(), area.Bottom()).GetStdIterator())
+	{
+		auto source = FetchBytes(offset + (stridelength * (size.Height() - 1 - y)) + first, length);
+		auto row = dest + (size_t(area.Width()) * (y - area.Top()));
+		if (skip == 0) { converter.Convert(source, row, count); }
+		else
+		{
+			converter.Convert(source, colors.data(), count);
+			std::copy(colors.begin() + skip, colors.end(), row);
+		}
+	}
+}
+const uint8_t* DIBCoreBitmapDecoder::FetchBytes(size_t pos, size_t length)
+{
+	//	ローダーがデータを直接参照できる場合は複製せずに変換する
+	auto peeked = loader.Peek(pos, length);
+	if (peeked != nullptr) { return (const uint8_t*)peeked; }
+	rowbuffer.resize(length);
+	DIBLoaderHelper::Read(loader, (char*)rowbuffer.data(), pos, length);
+	return rowbuffer.data();
+}
+DIBCoreBitmapDecoder::ValueType DIBCoreBitmapDecoder::GetUnchecked(const DisplayPoint& pos) const { return Get(ResolveIndex(pos)); }
+DIBCoreBitmapDecoder::ValueType DIBCoreBitmapDecoder::Get(size_t index) const
 {
 	size_t tgt = offset + ResolveOffset(index);
 	switch(bitdepth)
 	{
 		case DIBBitDepth::Bit1:
 		{
-			auto result = DIBPixelData<DIBBitDepth::Bit1>();
-			DIBLoaderHelper::Read(loader, result, tgt);
-			return ValueType(result);
+			auto data = uint8_t();
+			DIBLoaderHelper::Read(loader, data, tgt);
+			return ValueType(DIBPixelData<DIBBitDepth::Bit1>(ExtractPacked(data, index)));
 		}
 		case DIBBitDepth::Bit4:
 		{
-			auto result = DIBPixelData<DIBBitDepth::Bit4>();
-			DIBLoaderHelper::Read(loader, result, tgt);
-			return ValueType(result);
+			auto data = uint8_t();
+			DIBLoaderHelper::Read(loader, data, tgt);
+			return ValueType(DIBPixelData<DIBBitDepth::Bit4>(ExtractPacked(data, index)));
 		}
 		case DIBBitDepth::Bit8:
 		{
@@ -138,37 +235,83 @@ size_t DIBCoreBitmapDecoder::ResolveOffset(const DisplayPoint& pos) const
 {
 	if ( (pos.X() < 0)||(pos.Y() < 0) ) { throw std::invalid_argument("posに指定されている座標が無効です。"); }
 	if ( (size.Width() <= pos.X())||(size.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
-	return (stridelength * (size.Height() - 1 - pos.Y())) + (pixellength * pos.X());
+	return (stridelength * (size.Height() - 1 - pos.Y())) + ((uint16_t(bitdepth) * size_t(pos.X())) / 8);
 }
 size_t DIBCoreBitmapDecoder::ResolveOffset(size_t index) const
 {
-	if (length <= index) { throw std::out_of_range("指定されたインデックスはこの画像領域を超えています。"); }
-	return (stridelength * (index / size.Width())) + (pixellength * (index % size.Width()));
+	//	範囲の検査は呼び出し元で行われているため、ここでは行わない
+	return (stridelength * (index / size.Width())) + ((uint16_t(bitdepth) * (index % size.Width())) / 8);
+}
+uint32_t DIBCoreBitmapDecoder::ExtractPacked(uint8_t data, size_t index) const
+{
+	auto bits = uint16_t(bitdepth);
+	//	各バイトの上位ビットが左側のピクセルを表す
+	auto shift = 8 - bits - ((bits * (index % size.Width())) % 8);
+	return (data >> shift) & ((1U << bits) - 1);
+}
+uint8_t DIBCoreBitmapDecoder::InsertPacked(uint8_t data, uint32_t value, size_t index) const
+{
+	auto bits = uint16_t(bitdepth);
+	auto shift = 8 - bits - ((bits * (index % size.Width())) % 8);
+	auto mask = uint8_t(((1U << bits) - 1) << shift);
+	return uint8_t((data & ~mask) | ((value << shift) & mask));
 }
 
-DIBCoreBitmapEncoder::DIBCoreBitmapEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size)
-	: loader(loader), offset(offset), bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), current(0), pixellength(DIBCoreBitmapEncoder::GetPxLength(bitdepth)), stridelength(DIBCoreBitmapEncoder::GetStrideLength(bitdepth, size))
+DIBCoreBitmapEncoder::DIBCoreBitmapEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size, size_t batchrows)
+	: bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), current(0), pixellength(DIBCoreBitmapEncoder::GetPxLength(bitdepth)), stridelength(DIBCoreBitmapEncoder::GetStrideLength(bitdepth, size)), batch(loader, offset, size, DIBCoreBitmapEncoder::GetStrideLength(bitdepth, size), batchrows)
 {}
+DIBCoreBitmapEncoder::~DIBCoreBitmapEncoder()
+{
+	try { Flush(); }
+	catch (...) {}
+}
 void DIBCoreBitmapEncoder::Write(const ValueType& value)
 {
-	size_t tgt = offset + ResolveOffset(ResolvePos(current));
+	if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
+	auto x = size_t(current % size.Width());
+	auto dest = batch.Row(current);
+	auto data = std::visit([](auto i)->uint32_t { return uint32_t(i); }, value);
 	switch(bitdepth)
 	{
-		case DIBBitDepth::Bit1: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit1>>(value), tgt); break; }
-		case DIBBitDepth::Bit4: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit4>>(value), tgt); break; }
-		case DIBBitDepth::Bit8: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit8>>(value), tgt); break; }
-		case DIBBitDepth::Bit24: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit24>>(value), tgt); break; }
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		{
+			//	同じバイトに含まれる他のピクセルを保持して格納する
+			auto bits = uint16_t(bitdepth);
+			auto shift = 8 - bits - ((bits * x) % 8);
+			auto mask = uint8_t(((1U << bits) - 1) << shift);
+			auto& target = dest[(bits * x) / 8];
+			target = uint8_t((target & ~mask) | ((data << shift) & mask));
+			break;
+		}
+		case DIBBitDepth::Bit8:
+		case DIBBitDepth::Bit24:
+		{
+			//	ピクセルデータはリトルエンディアンで格納する
+			for (auto i: Range<size_t>(0, pixellength).GetStdIterator()) { dest[(x * pixellength) + i] = uint8_t(data >> (8 * i)); }
+			break;
+		}
 		default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
 	}
-	if (CurrentPos().X() == (size.Width() - 1))
-	{
-		size_t ci = size.Width() * ((uint16_t(bitdepth) + 7) / 8);
-		size_t stride = (((size.Width() * uint16_t(bitdepth)) + 31) % 32) / 8;
-		for (auto i: Range<size_t>(ci, stride).GetStdIterator()) { DIBLoaderHelper::Write(loader, char(), offset + i); }
-	}
 	++current;
+	batch.Advance(current);
+}
+void DIBCoreBitmapEncoder::WriteRow(const RGB8_t* row, const DIBRowConverter& packer)
+{
+	if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
+	if ((current % size.Width()) != 0) { throw InvalidOperationException("現在の位置が水平ラインの先頭ではありません。"); }
+	if (packer.BitDepth() != bitdepth) { throw std::invalid_argument("packerの各ピクセルのデータ長がこのオブジェクトと一致しません。"); }
+	packer.Pack(row, batch.Row(current), size.Width());
+	current += size.Width();
+	batch.Advance(current);
+}
+void DIBCoreBitmapEncoder::Flush() { batch.Flush(current); }
+void DIBCoreBitmapEncoder::Reset()
+{
+	Flush();
+	batch.Reset();
+	current = 0;
 }
-void DIBCoreBitmapEncoder::Reset() { current = 0; }
 bool DIBCoreBitmapEncoder::HasValue() const { return (0 <= current)&&(current < length); }
 Graphics::DisplayPoint DIBCoreBitmapEncoder::CurrentPos() const { return ResolvePos(current); }
 bool DIBCoreBitmapEncoder::Equals(const DIBCoreBitmapEncoder& other) const { return current == other.current; }
@@ -184,15 +327,16 @@ size_t DIBCoreBitmapEncoder::ResolveOffset(const DisplayPoint& pos) const
 {
 	if ( (pos.X() < 0)||(pos.Y() < 0) ) { throw std::invalid_argument("posに指定されている座標が無効です。"); }
 	if ( (size.Width() <= pos.X())||(size.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
-	return (stridelength * (size.Height() - 1 - pos.Y())) + (pixellength * pos.X());
+	return (stridelength * (size.Height() - 1 - pos.Y())) + ((uint16_t(bitdepth) * size_t(pos.X())) / 8);
 }
 size_t DIBCoreBitmapEncoder::GetPxLength(DIBBitDepth bitdepth) { return (uint16_t(bitdepth) + 7) / 8; }
-size_t DIBCoreBitmapEncoder::GetStrideLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return (((GetPxLength(bitdepth) * size.Width()) + 3) / 4) * 4; }
+size_t DIBCoreBitmapEncoder::GetRowLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return ((uint16_t(bitdepth) * size_t(size.Width())) + 7) / 8; }
+size_t DIBCoreBitmapEncoder::GetStrideLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return ((GetRowLength(bitdepth, size) + 3) / 4) * 4; }
 size_t DIBCoreBitmapEncoder::GetImageLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return GetStrideLength(bitdepth, size) * size.Height(); }
 
-DIBCoreBitmap::DIBCoreBitmap(DIBLoader&& loader) : loader(std::forward<DIBLoader>(loader))
+DIBCoreBitmap::DIBCoreBitmap(DIBLoader&& loader) : loader(std::forward<DIBLoader>(loader)), concurrency(1), tilecache()
 {
-	if (this->loader.IsEnable()) { throw InvalidOperationException("無効な状態のloaderが渡されました。"); }
+	if (!this->loader.IsEnable()) { throw InvalidOperationException("無効な状態のloaderが渡されました。"); }
 	if (this->loader.HeaderSize() < DIBCoreHeader::Size) { throw InvalidDIBFormatException("情報ヘッダの長さはCoreHeaderでサポートされる最小の長さよりも短いです。"); }
 	DIBLoaderHelper::Read(this->loader, ihead, sizeof(DIBFileHeader) + sizeof(int32_t));
 	size_t palettesize = 0;
@@ -210,6 +354,7 @@ DIBCoreBitmap::DIBCoreBitmap(DIBLoader&& loader) : loader(std::forward<DIBLoader
 		DIBLoaderHelper::Read(this->loader, p.data(), sizeof(DIBFileHeader) + DIBCoreHeader::Size, palettesize);
 		for (auto i: p) { palette.push_back(RGB8_t(i)); }
 	}
+	converter = DIBRowConverter(ihead.BitCount, palette);
 }
 std::optional<std::reference_wrapper<const std::vector<Graphics::RGB8_t>>> DIBCoreBitmap::Palette() const
 {
@@ -224,74 +369,66 @@ std::optional<std::reference_wrapper<const std::vector<Graphics::RGB8_t>>> DIBCo
 		default: { throw InvalidDIBFormatException("情報ヘッダのBitCountの内容が無効です。"); }
 	}
 }
+DIBCoreBitmap::PixelCursor DIBCoreBitmap::Cursor() { return PixelCursor(*this, DIBCoreBitmapDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height))); }
+DIBCoreBitmap::ImageView DIBCoreBitmap::View(int32_t rowcount) { return ImageView(*this, DisplayRectSize(ihead.Width, ihead.Height), rowcount); }
 DIBCoreBitmap::ValueType DIBCoreBitmap::GetPixel(const DisplayPoint& pos)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	return ConvertToRGB(decoder.Current());
+	if (tilecache.IsEnabled()) { return tilecache.Get(pos, [&](const DisplayRectangle& area, RGB8_t* dest) { DecodeRegion(area, dest); }); }
+	auto cursor = Cursor();
+	cursor.JumpTo(pos);
+	return cursor.Current();
 }
 std::vector<DIBCoreBitmap::ValueType> DIBCoreBitmap::GetPixel(const DisplayPoint& pos, size_t count)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	auto result = std::vector<DIBCoreBitmap::ValueType>();
-	result.reserve(count);
-	for (auto _: Range<size_t>(0, count).GetStdIterator()) { result.push_back(ConvertToRGB(decoder.Current())); }
-	return result;
+	return Cursor().Get(pos, count);
 }
 void DIBCoreBitmap::SetPixel(const DisplayPoint& pos, const ValueType& value)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	decoder.Write(ConvertToDecoderValue(value));
+	auto cursor = Cursor();
+	cursor.JumpTo(pos);
+	cursor.Write(value);
 }
 void DIBCoreBitmap::SetPixel(const DisplayPoint& pos, const std::vector<ValueType>& value)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	for(auto i: value) { decoder.Write(ConvertToDecoderValue(i)); }
+	Cursor().Write(pos, value);
 }
 DIBCoreBitmap::RawDataType DIBCoreBitmap::GetPixelRaw(const DisplayPoint& pos)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	return ConvertToRawData(decoder.Current());
+	auto cursor = Cursor();
+	cursor.JumpTo(pos);
+	return cursor.CurrentRaw();
 }
 std::vector<DIBCoreBitmap::RawDataType> DIBCoreBitmap::GetPixelRaw(const DisplayPoint& pos, size_t count)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	auto result = std::vector<RawDataType>();
-	result.reserve(count);
-	for (auto _: Range<size_t>(0, count).GetStdIterator()) { result.push_back(ConvertToRawData(decoder.Current())); }
-	return result;
+	return Cursor().GetRaw(pos, count);
 }
 void DIBCoreBitmap::SetPixelRaw(const DisplayPoint& pos, const RawDataType& value)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	decoder.Write(ConvertToDecoderValue(value));
+	auto cursor = Cursor();
+	cursor.JumpTo(pos);
+	cursor.WriteRaw(value);
 }
 void DIBCoreBitmap::SetPixelRaw(const DisplayPoint& pos, const std::vector<RawDataType>& value)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	decoder.JumpTo(pos);
-	for(auto i: value) { decoder.Write(ConvertToDecoderValue(i)); }
+	Cursor().WriteRaw(pos, value);
 }
 void DIBCoreBitmap::CopyTo(WritableImage<RGB8_t>& dest)
 {
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	for (decoder.Reset(); decoder.HasValue(); decoder.Next()) { dest.At(decoder.CurrentPos()) = ConvertToRGB(decoder.Current()); }
+	auto offset = size_t(loader.FileHead().Offset());
+	DIBBandDecodeHelper::Decode(loader, ihead.Width, 0, ihead.Height, concurrency,
+		[&](DIBLoader& reader, int32_t y0, int32_t y1, RGB8_t* rows) { DIBCoreBitmapDecoder(reader, offset, ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height)).DecodeRowsUnchecked(y0, y1, rows, converter); },
+		[&](int32_t y, const RGB8_t* row) { for (auto x: Range<int32_t>(0, ihead.Width).GetStdIterator()) { dest.At(DisplayPoint(x, y)) = row[x]; } }
+	);
 }
 void DIBCoreBitmap::CopyTo(WritableImage<RGB8_t>& dest, const DisplayRectangle& area, const DisplayPoint& destorigin)
 {
 	if ((area.Left() < 0)||(area.Top() < 0)||(ihead.Width < area.Right())||(ihead.Height < area.Bottom())) { throw std::out_of_range("areaで指定された領域がビットマップの画像領域を超えています。"); }
-	auto decoder = DIBCoreBitmapDecoder(loader, sizeof(DIBFileHeader) + loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-	for (decoder.JumpTo(DisplayPoint(area.Left(), area.Bottom())); decoder.HasValue(); decoder.Next())
-	{
-		if (area.Contains(decoder.CurrentPos())) { decoder.Next(ihead.Width - area.Width() - 1); continue; }
-		dest.At(decoder.CurrentPos() - area.Origin() + destorigin) = ConvertToRGB(decoder.Current());
-	}
+	if (tilecache.IsEnabled()) { tilecache.CopyTo(dest, area, destorigin, [&](const DisplayRectangle& tile, RGB8_t* rows) { DecodeRegion(tile, rows); }); return; }
+	auto offset = size_t(loader.FileHead().Offset());
+	DIBBandDecodeHelper::Decode(loader, area.Width(), area.Top(), area.Bottom(), concurrency,
+		[&](DIBLoader& reader, int32_t y0, int32_t y1, RGB8_t* rows) { DIBCoreBitmapDecoder(reader, offset, ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height)).DecodeRegionUnchecked(DisplayRectangle(area.Left(), y0, area.Width(), y1 - y0), rows, converter); },
+		[&](int32_t y, const RGB8_t* row) { for (auto x: Range<int32_t>(0, area.Width()).GetStdIterator()) { dest.At(DisplayPoint(area.Left() + x, y) - area.Origin() + destorigin) = row[x]; } }
+	);
 }
 DIBCoreBitmap::Pixmap DIBCoreBitmap::ToPixmap()
 {
@@ -305,8 +442,8 @@ DIBCoreBitmap::Pixmap DIBCoreBitmap::ToPixmap(const DisplayRectangle& area)
 	CopyTo(result, area);
 	return result;
 }
-std::optional<DIBCoreBitmap> DIBCoreBitmap::Generate(DIBLoader&& loader, const DIBCoreHeader& header, const Image<RGB8_t>& image) { return Generate(std::forward<DIBLoader>(loader), header, std::vector<RGB8_t>(), image); }
-std::optional<DIBCoreBitmap> DIBCoreBitmap::Generate(DIBLoader&& loader, const DIBCoreHeader& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image)
+std::optional<DIBCoreBitmap> DIBCoreBitmap::Generate(DIBLoader&& loader, const DIBCoreHeader& header, const Image<RGB8_t>& image, size_t concurrency) { return Generate(std::forward<DIBLoader>(loader), header, std::vector<RGB8_t>(), image, concurrency); }
+std::optional<DIBCoreBitmap> DIBCoreBitmap::Generate(DIBLoader&& loader, const DIBCoreHeader& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image, size_t concurrency)
 {
 	auto fhead = DIBFileHeader();
 	std::copy(&(fhead.FileType_Signature[0]), &(fhead.FileType_Signature[2]), &(fhead.FileType[0]));
@@ -321,23 +458,19 @@ std::optional<DIBCoreBitmap> DIBCoreBitmap::Generate(DIBLoader&& loader, const D
 	}
 	fhead.Offset(int32_t(sizeof(DIBFileHeader) + DIBCoreHeader::Size) + (sizeof(RGBTriple_t) * palsize));
 	fhead.FileSize(int32_t(sizeof(DIBFileHeader) + DIBCoreHeader::Size + (sizeof(RGBTriple_t) * palsize) + DIBCoreBitmapEncoder::GetImageLength(header.BitCount, DisplayRectSize(header.Width, header.Height))));
-	DIBLoaderHelper::Write(loader, fhead, 0);
-	DIBLoaderHelper::Write(loader, DIBCoreHeader::Size, sizeof(DIBFileHeader));
-	DIBLoaderHelper::Write(loader, header, sizeof(DIBFileHeader) + sizeof(uint32_t));
-	for (auto i: Range<size_t>(0, palsize).GetStdIterator())
-	{
-		if (palette.size() < i) { DIBLoaderHelper::Write(loader, RGBTriple_t(palette[i]), sizeof(DIBFileHeader) + DIBCoreHeader::Size + (sizeof(RGBTriple_t) * i)); }
-		else { DIBLoaderHelper::Write(loader, RGBTriple_t(), sizeof(DIBFileHeader) + DIBCoreHeader::Size + (sizeof(RGBTriple_t) * i)); }
-	}
-	auto encoder = DIBCoreBitmapEncoder(loader, fhead.Offset(), header.BitCount, DisplayRectSize(header.Width, header.Height));
-	switch(header.BitCount)
+	auto entries = std::vector<RGBTriple_t>(palsize);
+	for (auto i: Range<size_t>(0, std::min(palsize, palette.size())).GetStdIterator()) { entries[i] = RGBTriple_t(palette[i]); }
+	//	ヘッダと色パレットはファイル上で連続しているため、まとめて書き込む
+	loader.WriteV(
 	{
-		case DIBBitDepth::Bit1: { while (encoder.HasValue()) { encoder.Write(DIBPixelData<DIBBitDepth::Bit1>()); } break; }
-		case DIBBitDepth::Bit4: { while (encoder.HasValue()) { encoder.Write(DIBPixelData<DIBBitDepth::Bit4>()); } break; }
-		case DIBBitDepth::Bit8: { while (encoder.HasValue()) { encoder.Write(DIBPixelData<DIBBitDepth::Bit8>()); } break; }
-		case DIBBitDepth::Bit24: { while (encoder.HasValue()) { encoder.Write(DIBPixelPerser::ToPixel24(image.At(encoder.CurrentPos()))); } break; }
-		default: { throw std::invalid_argument("BitCountの内容が無効です。"); }
-	}
+		DIBLoaderHelper::Segment(fhead, 0),
+		DIBLoaderHelper::Segment(DIBCoreHeader::Size, sizeof(DIBFileHeader)),
+		DIBLoaderHelper::Segment(header, sizeof(DIBFileHeader) + sizeof(uint32_t)),
+		DIBLoaderHelper::Segment(entries.data(), sizeof(DIBFileHeader) + DIBCoreHeader::Size, entries.size())
+	});
+	DIBBandEncodeHelper::Encode(loader, fhead.Offset(), DisplayRectSize(header.Width, header.Height), DIBRowConverter(header.BitCount), image, concurrency);
+	//	書き込み専用のローダーはビットマップとして読み込むことができないため、書き込みのみを行う
+	if (!loader.IsReadable()) { loader.Sync(); return std::nullopt; }
 	try
 	{
 		loader.Sync();
@@ -348,6 +481,12 @@ std::optional<DIBCoreBitmap> DIBCoreBitmap::Generate(DIBLoader&& loader, const D
 		return std::nullopt;
 	}
 }
+void DIBCoreBitmap::SetTileCache(size_t capacity, int32_t tilesize) { tilecache = DIBTileCache(DisplayRectSize(ihead.Width, ihead.Height), capacity, tilesize); }
+void DIBCoreBitmap::DecodeRegion(const DisplayRectangle& area, RGB8_t* dest)
+{
+	//	領域は呼び出し元で画像の範囲に収められている
+	DIBCoreBitmapDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height)).DecodeRegionUnchecked(area, dest, converter);
+}
 DIBCoreBitmap::ValueType DIBCoreBitmap::ConvertToRGB(const DIBCoreBitmapDecoder::ValueType& data) const
 {
 	switch(ihead.BitCount)
@@ -356,7 +495,10 @@ DIBCoreBitmap::ValueType DIBCoreBitmap::ConvertToRGB(const DIBCoreBitmapDecoder:
 		case DIBBitDepth::Bit4:
 		case DIBBitDepth::Bit8:
 		{
-			return palette.at(std::visit([](auto i)->uint32_t { return uint32_t(i); }, data));
+			//	行単位の変換と同様に、色パレットの範囲外のインデックスは形式の誤りとして扱う
+			auto index = std::visit([](auto i)->uint32_t { return uint32_t(i); }, data);
+			if (palette.size() <= index) { throw InvalidDIBFormatException("色パレットの範囲外のインデックスが含まれています。"); }
+			return palette[index];
 		}
 		case DIBBitDepth::Bit24:
 		{
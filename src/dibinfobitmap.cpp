@@ -20,7 +20,7 @@
 using namespace zawa_ch::StationaryOrbit;
 using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
 
-DIBInfoBitmap::DIBInfoBitmap(DIBLoader&& loader) : loader(std::forward<DIBLoader>(loader))
+DIBInfoBitmap::DIBInfoBitmap(DIBLoader&& loader) : loader(std::forward<DIBLoader>(loader)), concurrency(1), tilecache()
 {
 	if (!this->loader.IsEnable()) { throw InvalidOperationException("無効な状態のloaderが渡されました。"); }
 	if (this->loader.HeaderSize() < DIBInfoHeader::Size) { throw InvalidDIBFormatException("情報ヘッダの長さはInfoHeaderでサポートされる最小の長さよりも短いです。"); }
@@ -30,22 +30,26 @@ DIBInfoBitmap::DIBInfoBitmap(DIBLoader&& loader) : loader(std::forward<DIBLoader
 		auto colormaskdata = DIBRGBColorMask();
 		DIBLoaderHelper::Read(this->loader, colormaskdata, sizeof(DIBFileHeader) + DIBInfoHeader::Size);
 		colormask = DIBColorMask(colormaskdata);
+		bitfields = DIBBitFields(colormaskdata);
 	}
 	else if (ihead.Compression == DIBCompressionMethod::ALPHABITFIELDS)
 	{
 		auto colormaskdata = DIBRGBAColorMask();
 		DIBLoaderHelper::Read(this->loader, colormaskdata, sizeof(DIBFileHeader) + DIBInfoHeader::Size);
 		colormask = DIBColorMask(colormaskdata);
+		bitfields = DIBBitFields(colormaskdata);
 	}
 	if ((ihead.Compression == DIBCompressionMethod::RGB)&&(uint16_t(ihead.BitCount) <= uint16_t(DIBBitDepth::Bit8)))
 	{
 		size_t palsize = ihead.ClrUsed;
 		if (palsize == 0) { palsize = 1 << uint16_t(ihead.BitCount); }
 		auto lpal = std::vector<RGBQuad_t>(palsize);
-		DIBLoaderHelper::Read(this->loader, lpal.data(), sizeof(DIBFileHeader) + sizeof(DIBInfoHeader), palsize);
+		DIBLoaderHelper::Read(this->loader, lpal.data(), sizeof(DIBFileHeader) + this->loader.HeaderSize(), palsize);
 		palette.reserve(palsize);
 		for(auto i: lpal) { palette.push_back(RGB8_t(i)); }
 	}
+	if (ihead.Compression == DIBCompressionMethod::RGB) { converter = DIBRowConverter(ihead.BitCount, palette); }
+	if ((ihead.Compression == DIBCompressionMethod::BITFIELDS)||(ihead.Compression == DIBCompressionMethod::ALPHABITFIELDS)) { converter = DIBRowConverter(ihead.BitCount, bitfields); }
 }
 std::optional<std::reference_wrapper<const DIBColorMask>> DIBInfoBitmap::ColorMask() const
 {
@@ -68,23 +72,58 @@ std::optional<std::reference_wrapper<const std::vector<Graphics::RGB8_t>>> DIBIn
 	if (ihead.ClrUsed != 0) { return palette; }
 	else { return std::nullopt; }
 }
+DIBInfoBitmap::PixelCursor DIBInfoBitmap::Cursor()
+{
+	switch(ihead.Compression)
+	{
+		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
+		{ return PixelCursor(*this, DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height))); }
+		case DIBCompressionMethod::RLE4:
+		case DIBCompressionMethod::RLE8:
+		case DIBCompressionMethod::JPEG:
+		case DIBCompressionMethod::PNG:
+		//	TODO: Implement
+		{ throw NotImplementedException(); }
+		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
+	}
+}
+DIBInfoBitmap::ImageView DIBInfoBitmap::View(int32_t rowcount)
+{
+	switch(ihead.Compression)
+	{
+		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
+		{ return ImageView(*this, DisplayRectSize(ihead.Width, ihead.Height), rowcount); }
+		case DIBCompressionMethod::RLE4:
+		case DIBCompressionMethod::RLE8:
+		case DIBCompressionMethod::JPEG:
+		case DIBCompressionMethod::PNG:
+		//	TODO: Implement
+		{ throw NotImplementedException(); }
+		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
+	}
+}
 DIBInfoBitmap::ValueType DIBInfoBitmap::GetPixel(const DisplayPoint& pos)
 {
 	switch(ihead.Compression)
 	{
 		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			return ConvertToRGB(decoder.Current());
+			if (tilecache.IsEnabled()) { return tilecache.Get(pos, [&](const DisplayRectangle& area, RGB8_t* dest) { DecodeRegion(area, dest); }); }
+			auto cursor = Cursor();
+			cursor.JumpTo(pos);
+			return cursor.Current();
 			break;
 		}
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::RLE8:
-		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::JPEG:
 		case DIBCompressionMethod::PNG:
-		case DIBCompressionMethod::ALPHABITFIELDS:
 		//	TODO: Implement
 		{ throw NotImplementedException(); }
 		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
@@ -95,20 +134,15 @@ std::vector<DIBInfoBitmap::ValueType> DIBInfoBitmap::GetPixel(const DisplayPoint
 	switch(ihead.Compression)
 	{
 		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			auto result = std::vector<DIBInfoBitmap::ValueType>();
-			result.reserve(count);
-			for (auto _: Range<size_t>(0, count).GetStdIterator()) { result.push_back(ConvertToRGB(decoder.Current())); }
-			return result;
+			return Cursor().Get(pos, count);
 		}
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::RLE8:
-		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::JPEG:
 		case DIBCompressionMethod::PNG:
-		case DIBCompressionMethod::ALPHABITFIELDS:
 		//	TODO: Implement
 		{ throw NotImplementedException(); }
 		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
@@ -119,22 +153,18 @@ void DIBInfoBitmap::SetPixel(const DisplayPoint& pos, const ValueType& value)
 	switch(ihead.Compression)
 	{
 		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			decoder.Write(ConvertToRGBDecoderValue(value));
+			auto cursor = Cursor();
+			cursor.JumpTo(pos);
+			cursor.Write(value);
 			break;
 		}
 		case DIBCompressionMethod::RLE4: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
 		case DIBCompressionMethod::RLE8: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
-		case DIBCompressionMethod::BITFIELDS:
-		//	TODO: Implement
-		{ throw NotImplementedException(); }
 		case DIBCompressionMethod::JPEG: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
 		case DIBCompressionMethod::PNG: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
-		case DIBCompressionMethod::ALPHABITFIELDS:
-		//	TODO: Implement
-		{ throw NotImplementedException(); }
 		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
 	}
 }
@@ -143,22 +173,16 @@ void DIBInfoBitmap::SetPixel(const DisplayPoint& pos, const std::vector<ValueTyp
 	switch(ihead.Compression)
 	{
 		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			for(auto i: value) { decoder.Write(ConvertToRGBDecoderValue(i)); }
+			Cursor().Write(pos, value);
 			break;
 		}
 		case DIBCompressionMethod::RLE4: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
 		case DIBCompressionMethod::RLE8: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
-		case DIBCompressionMethod::BITFIELDS:
-		//	TODO: Implement
-		{ throw NotImplementedException(); }
 		case DIBCompressionMethod::JPEG: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
 		case DIBCompressionMethod::PNG: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
-		case DIBCompressionMethod::ALPHABITFIELDS:
-		//	TODO: Implement
-		{ throw NotImplementedException(); }
 		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
 	}
 }
@@ -170,9 +194,9 @@ DIBInfoBitmap::RawDataType DIBInfoBitmap::GetPixelRaw(const DisplayPoint& pos)
 		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			return ConvertToRawData(decoder.Current());
+			auto cursor = Cursor();
+			cursor.JumpTo(pos);
+			return cursor.CurrentRaw();
 		}
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::RLE8:
@@ -191,12 +215,7 @@ std::vector<DIBInfoBitmap::RawDataType> DIBInfoBitmap::GetPixelRaw(const Display
 		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			auto result = std::vector<RawDataType>();
-			result.reserve(count);
-			for (auto _: Range<size_t>(0, count).GetStdIterator()) { result.push_back(ConvertToRawData(decoder.Current())); }
-			return result;
+			return Cursor().GetRaw(pos, count);
 		}
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::RLE8:
@@ -215,9 +234,9 @@ void DIBInfoBitmap::SetPixelRaw(const DisplayPoint& pos, const RawDataType& valu
 		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			decoder.Write(ConvertToRGBDecoderValue(value));
+			auto cursor = Cursor();
+			cursor.JumpTo(pos);
+			cursor.WriteRaw(value);
 			break;
 		}
 		case DIBCompressionMethod::RLE4: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
@@ -235,9 +254,7 @@ void DIBInfoBitmap::SetPixelRaw(const DisplayPoint& pos, const std::vector<RawDa
 		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			decoder.JumpTo(pos);
-			for(auto i: value) { decoder.Write(ConvertToRGBDecoderValue(i)); }
+			Cursor().WriteRaw(pos, value);
 			break;
 		}
 		case DIBCompressionMethod::RLE4: { throw InvalidOperationException("現在のComplessionMethodでの書き込みはサポートされていません。"); }
@@ -252,17 +269,20 @@ void DIBInfoBitmap::CopyTo(WritableImage<RGB8_t>& dest)
 	switch(ihead.Compression)
 	{
 		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			for (decoder.Reset(); decoder.HasValue(); decoder.Next()) { dest.At(decoder.CurrentPos()) = ConvertToRGB(decoder.Current()); }
+			auto offset = size_t(loader.FileHead().Offset());
+			DIBBandDecodeHelper::Decode(loader, ihead.Width, 0, ihead.Height, concurrency,
+				[&](DIBLoader& reader, int32_t y0, int32_t y1, RGB8_t* rows) { DIBRGBDecoder(reader, offset, ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height)).DecodeRowsUnchecked(y0, y1, rows, converter); },
+				[&](int32_t y, const RGB8_t* row) { for (auto x: Range<int32_t>(0, ihead.Width).GetStdIterator()) { dest.At(DisplayPoint(x, y)) = row[x]; } }
+			);
 			break;
 		}
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::RLE8:
-		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::JPEG:
 		case DIBCompressionMethod::PNG:
-		case DIBCompressionMethod::ALPHABITFIELDS:
 		//	TODO: Implement
 		{ throw NotImplementedException(); }
 		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
@@ -274,21 +294,21 @@ void DIBInfoBitmap::CopyTo(WritableImage<RGB8_t>& dest, const DisplayRectangle&
 	switch(ihead.Compression)
 	{
 		case DIBCompressionMethod::RGB:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
 		{
-			auto decoder = DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height));
-			for (decoder.JumpTo(DisplayPoint(area.Left(), area.Bottom())); decoder.HasValue(); decoder.Next())
-			{
-				if (area.Contains(decoder.CurrentPos())) { decoder.Next(ihead.Width - area.Width() - 1); continue; }
-				dest.At(decoder.CurrentPos() - area.Origin() + destorigin) = ConvertToRGB(decoder.Current());
-			}
+			if (tilecache.IsEnabled()) { tilecache.CopyTo(dest, area, destorigin, [&](const DisplayRectangle& tile, RGB8_t* rows) { DecodeRegion(tile, rows); }); break; }
+			auto offset = size_t(loader.FileHead().Offset());
+			DIBBandDecodeHelper::Decode(loader, area.Width(), area.Top(), area.Bottom(), concurrency,
+				[&](DIBLoader& reader, int32_t y0, int32_t y1, RGB8_t* rows) { DIBRGBDecoder(reader, offset, ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height)).DecodeRegionUnchecked(DisplayRectangle(area.Left(), y0, area.Width(), y1 - y0), rows, converter); },
+				[&](int32_t y, const RGB8_t* row) { for (auto x: Range<int32_t>(0, area.Width()).GetStdIterator()) { dest.At(DisplayPoint(area.Left() + x, y) - area.Origin() + destorigin) = row[x]; } }
+			);
 			break;
 		}
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::RLE8:
-		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::JPEG:
 		case DIBCompressionMethod::PNG:
-		case DIBCompressionMethod::ALPHABITFIELDS:
 		//	TODO: Implement
 		{ throw NotImplementedException(); }
 		default: { throw InvalidOperationException("情報ヘッダのComplessionMethodの内容が無効です。"); }
@@ -306,8 +326,8 @@ DIBInfoBitmap::Pixmap DIBInfoBitmap::ToPixmap(const DisplayRectangle& area)
 	CopyTo(result, area);
 	return result;
 }
-std::optional<DIBInfoBitmap> DIBInfoBitmap::Generate(DIBLoader&& loader, const DIBInfoHeader& header, const Image<RGB8_t>& image) { return Generate(std::forward<DIBLoader>(loader), header, std::vector<RGB8_t>(), image); }
-std::optional<DIBInfoBitmap> DIBInfoBitmap::Generate(DIBLoader&& loader, const DIBInfoHeader& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image)
+std::optional<DIBInfoBitmap> DIBInfoBitmap::Generate(DIBLoader&& loader, const DIBInfoHeader& header, const Image<RGB8_t>& image, size_t concurrency) { return Generate(std::forward<DIBLoader>(loader), header, std::vector<RGB8_t>(), image, concurrency); }
+std::optional<DIBInfoBitmap> DIBInfoBitmap::Generate(DIBLoader&& loader, const DIBInfoHeader& header, const std::vector<RGB8_t> palette, const Image<RGB8_t>& image, size_t concurrency)
 {
 	auto fhead = DIBFileHeader();
 	std::copy(&(fhead.FileType_Signature[0]), &(fhead.FileType_Signature[2]), &(fhead.FileType[0]));
@@ -336,25 +356,19 @@ std::optional<DIBInfoBitmap> DIBInfoBitmap::Generate(DIBLoader&& loader, const D
 			}
 			fhead.Offset(int32_t(sizeof(DIBFileHeader) + DIBInfoHeader::Size) + (sizeof(RGBQuad_t) * palsize));
 			fhead.FileSize(int32_t(sizeof(DIBFileHeader) + DIBInfoHeader::Size + (sizeof(RGBQuad_t) * palsize) + (DIBRGBEncoder::GetStrideLength(header.BitCount, DisplayRectSize(header.Width, header.Height)) * header.Height)));
-			DIBLoaderHelper::Write(loader, fhead, 0);
-			DIBLoaderHelper::Write(loader, DIBInfoHeader::Size, sizeof(DIBFileHeader));
-			DIBLoaderHelper::Write(loader, header, sizeof(DIBFileHeader) + sizeof(uint32_t));
-			for (auto i: Range<size_t>(0, palsize).GetStdIterator())
-			{
-				if (palette.size() < i) { DIBLoaderHelper::Write(loader, RGBQuad_t(palette[i]), sizeof(DIBFileHeader) + DIBInfoHeader::Size + (sizeof(RGBQuad_t) * i)); }
-				else { DIBLoaderHelper::Write(loader, RGBQuad_t(), sizeof(DIBFileHeader) + DIBInfoHeader::Size + (sizeof(RGBQuad_t) * i)); }
-			}
-			auto encoder = DIBRGBEncoder(loader, fhead.Offset(), header.BitCount, DisplayRectSize(header.Width, header.Height));
-			switch(header.BitCount)
+			auto entries = std::vector<RGBQuad_t>(palsize);
+			for (auto i: Range<size_t>(0, std::min(palsize, palette.size())).GetStdIterator()) { entries[i] = RGBQuad_t(palette[i]); }
+			//	ヘッダと色パレットはファイル上で連続しているため、まとめて書き込む
+			loader.WriteV(
 			{
-				case DIBBitDepth::Bit1: { while (encoder.HasValue()) { encoder.Write(DIBPixelData<DIBBitDepth::Bit1>()); } break; }
-				case DIBBitDepth::Bit4: { while (encoder.HasValue()) { encoder.Write(DIBPixelData<DIBBitDepth::Bit4>()); } break; }
-				case DIBBitDepth::Bit8: { while (encoder.HasValue()) { encoder.Write(DIBPixelData<DIBBitDepth::Bit8>()); } break; }
-				case DIBBitDepth::Bit16: { while (encoder.HasValue()) { encoder.Write(DIBPixelPerser::ToPixel16(image.At(encoder.CurrentPos()))); } break; }
-				case DIBBitDepth::Bit24: { while (encoder.HasValue()) { encoder.Write(DIBPixelPerser::ToPixel24(image.At(encoder.CurrentPos()))); } break; }
-				case DIBBitDepth::Bit32: { while (encoder.HasValue()) { encoder.Write(DIBPixelPerser::ToPixel32(image.At(encoder.CurrentPos()))); } break; }
-				default: { throw std::invalid_argument("BitCountの内容が無効です。"); }
-			}
+				DIBLoaderHelper::Segment(fhead, 0),
+				DIBLoaderHelper::Segment(DIBInfoHeader::Size, sizeof(DIBFileHeader)),
+				DIBLoaderHelper::Segment(header, sizeof(DIBFileHeader) + sizeof(uint32_t)),
+				DIBLoaderHelper::Segment(entries.data(), sizeof(DIBFileHeader) + DIBInfoHeader::Size, entries.size())
+			});
+			DIBBandEncodeHelper::Encode(loader, fhead.Offset(), DisplayRectSize(header.Width, header.Height), DIBRowConverter(header.BitCount), image, concurrency);
+			//	書き込み専用のローダーはビットマップとして読み込むことができないため、書き込みのみを行う
+			if (!loader.IsReadable()) { loader.Sync(); return std::nullopt; }
 			try
 			{
 				loader.Sync();
@@ -375,6 +389,12 @@ std::optional<DIBInfoBitmap> DIBInfoBitmap::Generate(DIBLoader&& loader, const D
 		default: { throw std::invalid_argument("CompressionMethodの内容が無効です。"); }
 	}
 }
+void DIBInfoBitmap::SetTileCache(size_t capacity, int32_t tilesize) { tilecache = DIBTileCache(DisplayRectSize(ihead.Width, ihead.Height), capacity, tilesize); }
+void DIBInfoBitmap::DecodeRegion(const DisplayRectangle& area, RGB8_t* dest)
+{
+	//	領域は呼び出し元で画像の範囲に収められている
+	DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, DisplayRectSize(ihead.Width, ihead.Height)).DecodeRegionUnchecked(area, dest, converter);
+}
 DIBInfoBitmap::ValueType DIBInfoBitmap::ConvertToRGB(const DIBRGBDecoder::ValueType& data) const
 {
 	switch(ihead.Compression)
@@ -386,7 +406,10 @@ DIBInfoBitmap::ValueType DIBInfoBitmap::ConvertToRGB(const DIBRGBDecoder::ValueT
 				case DIBBitDepth::Bit4:
 				case DIBBitDepth::Bit8:
 				{
-					return palette.at(std::visit([](auto i)->uint32_t { return uint32_t(i); }, data));
+					//	行単位の変換と同様に、色パレットの範囲外のインデックスは形式の誤りとして扱う
+					auto index = std::visit([](auto i)->uint32_t { return uint32_t(i); }, data);
+					if (palette.size() <= index) { throw InvalidDIBFormatException("色パレットの範囲外のインデックスが含まれています。"); }
+					return palette[index];
 				}
 				case DIBBitDepth::Bit16: { return DIBPixelPerser::ToRGB(std::get<DIBPixelData<DIBBitDepth::Bit16>>(data)); }
 				case DIBBitDepth::Bit24: { return DIBPixelPerser::ToRGB(std::get<DIBPixelData<DIBBitDepth::Bit24>>(data)); }
@@ -396,8 +419,7 @@ DIBInfoBitmap::ValueType DIBInfoBitmap::ConvertToRGB(const DIBRGBDecoder::ValueT
 			break;
 		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::ALPHABITFIELDS:
-		//	TODO: Implement
-		{ throw NotImplementedException(); }
+		{ return bitfields.ToRGB(std::visit([](auto i)->uint32_t { return uint32_t(i); }, data)); }
 		case DIBCompressionMethod::RLE8:
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::JPEG:
@@ -421,7 +443,7 @@ DIBInfoBitmap::RawDataType DIBInfoBitmap::ConvertToRawData(const DIBRGBDecoder::
 		default: { throw InvalidDIBFormatException("情報ヘッダのBitCountの内容が無効です。"); }
 	}
 }
-DIBRGBDecoder::ValueType DIBInfoBitmap::ConvertToRGBDecoderValue(const ValueType& value) const
+DIBRGBDecoder::ValueType DIBInfoBitmap::ConvertToDecoderValue(const ValueType& value) const
 {
 	switch(ihead.Compression)
 	{
@@ -441,8 +463,13 @@ DIBRGBDecoder::ValueType DIBInfoBitmap::ConvertToRGBDecoderValue(const ValueType
 			break;
 		case DIBCompressionMethod::BITFIELDS:
 		case DIBCompressionMethod::ALPHABITFIELDS:
-		//	TODO: Implement
-		{ throw NotImplementedException(); }
+			switch(ihead.BitCount)
+			{
+				case DIBBitDepth::Bit16: { return DIBPixelData<DIBBitDepth::Bit16>(bitfields.ToPixel(value)); }
+				case DIBBitDepth::Bit32: { return DIBPixelData<DIBBitDepth::Bit32>(bitfields.ToPixel(value)); }
+				default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
+			}
+			break;
 		case DIBCompressionMethod::RLE8:
 		case DIBCompressionMethod::RLE4:
 		case DIBCompressionMethod::JPEG:
@@ -450,7 +477,7 @@ DIBRGBDecoder::ValueType DIBInfoBitmap::ConvertToRGBDecoderValue(const ValueType
 		default: { throw InvalidOperationException("情報ヘッダのComressionMethodの内容が無効です。"); }
 	}
 }
-DIBRGBDecoder::ValueType DIBInfoBitmap::ConvertToRGBDecoderValue(const RawDataType& value) const
+DIBRGBDecoder::ValueType DIBInfoBitmap::ConvertToDecoderValue(const RawDataType& value) const
 {
 	switch(ihead.BitCount)
 	{
@@ -16,32 +16,56 @@
 //	along with this program.
 //	If not, see <http://www.gnu.org/licenses/>.
 //
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include "stationaryorbit/graphics-dib/dibloader.hpp"
 using namespace zawa_ch::StationaryOrbit;
 using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
 
-DIBFileLoader::DIBFileLoader() : stream(), fhead(), headersize() {}
-DIBFileLoader::DIBFileLoader(std::fstream&& stream) : stream(std::move(stream)), fhead(), headersize() { LoadHead(); }
-DIBFileLoader::DIBFileLoader(const char* filename, std::ios_base::openmode mode) : DIBFileLoader(std::move(std::fstream(filename, mode))) {}
-DIBFileLoader::DIBFileLoader(const std::string& filename, std::ios_base::openmode mode) : DIBFileLoader(std::move(std::fstream(filename, mode))) {}
+DIBFileLoader::DIBFileLoader() : stream(), filename(), fhead(), headersize(), blocksize(DefaultCacheBlockSize), blockcount(DefaultCacheBlockCount), cache(), cacheindex(), statistics() {}
+DIBFileLoader::DIBFileLoader(std::fstream&& stream) : stream(std::move(stream)), filename(), fhead(), headersize(), blocksize(DefaultCacheBlockSize), blockcount(DefaultCacheBlockCount), cache(), cacheindex(), statistics() { LoadHead(); }
+DIBFileLoader::DIBFileLoader(const char* filename, std::ios_base::openmode mode) : DIBFileLoader(std::move(std::fstream(filename, mode))) { this->filename = filename; }
+DIBFileLoader::DIBFileLoader(const std::string& filename, std::ios_base::openmode mode) : DIBFileLoader(std::move(std::fstream(filename, mode))) { this->filename = filename; }
 bool DIBFileLoader::IsEnable() const { return fhead.CheckFileHeader(); }
+void DIBFileLoader::SetCache(size_t blocksize, size_t blockcount)
+{
+	if (blocksize == 0) { throw std::invalid_argument("blocksizeに0を指定することはできません。"); }
+	ClearCache();
+	this->blocksize = blocksize;
+	this->blockcount = blockcount;
+}
+void DIBFileLoader::ClearCache() noexcept
+{
+	cacheindex.clear();
+	cache.clear();
+}
+void DIBFileLoader::ResetCacheStatistics() noexcept { statistics = DIBLoaderCacheStatistics(); }
 void DIBFileLoader::Sync() noexcept
 {
 	Flush();
+	ClearCache();
 	LoadHead();
 }
 void DIBFileLoader::Read(char* dest, size_t pos, size_t length)
 {
-	if (stream.bad()) { throw InvalidOperationException("ストリームの状態が無効です。"); }
-	if (stream.tellg() != pos)
+	//	キャッシュが無効、またはブロック長以上の読み込みはストリームから直接行う
+	if ((blockcount == 0)||(blocksize <= length)) { ReadStream(dest, pos, length); return; }
+	while (0 < length)
 	{
-		if (stream.seekg(pos).fail()) { stream.clear(); throw std::ios_base::failure("ストリームのシークに失敗しました。"); }
-	}
-	if (stream.read(dest, length).fail())
-	{
-		if (stream.eof()) { stream.clear(); throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
-		stream.clear();
-		throw std::ios_base::failure("ストリームの読み取りに失敗しました。");
+		const auto& block = FetchBlock(pos / blocksize);
+		size_t blockoffset = pos % blocksize;
+		if (block.data.size() <= blockoffset) { throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
+		size_t count = std::min(length, block.data.size() - blockoffset);
+		std::copy(block.data.data() + blockoffset, block.data.data() + blockoffset + count, dest);
+		dest += count;
+		pos += count;
+		length -= count;
 	}
 }
 void DIBFileLoader::Write(const char* source, size_t pos, size_t length)
@@ -51,7 +75,39 @@ void DIBFileLoader::Write(const char* source, size_t pos, size_t length)
 	{
 		if (stream.seekp(pos).fail()) { stream.clear(); throw std::ios_base::failure("ストリームのシークに失敗しました。"); }
 	}
-	if (stream.write(source, length).fail()) { stream.clear(); throw std::ios_base::failure("ストリームの書き込みに失敗しました。"); }
+	if (stream.write(source, length).fail()) { stream.clear(); InvalidateBlocks(pos, length); throw std::ios_base::failure("ストリームの書き込みに失敗しました。"); }
+	InvalidateBlocks(pos, length);
+}
+void DIBFileLoader::WriteV(const std::vector<DIBWriteSegment>& segments)
+{
+	if (stream.bad()) { throw InvalidOperationException("ストリームの状態が無効です。"); }
+	Flush();
+	//	書き込みの途中で失敗した場合にも古い内容が読み込まれないよう、先にキャッシュから破棄する
+	for (const auto& segment: segments) { InvalidateBlocks(segment.Position, segment.Length); }
+	//	std::fstream はファイル記述子を公開しないため、位置が連続する領域はシークを1回にまとめて順に書き込む
+	auto end = size_t(0U);
+	auto positioned = false;
+	for (const auto& segment: segments)
+	{
+		if (segment.Length == 0) { continue; }
+		if ((!positioned)||(segment.Position != end))
+		{
+			if (stream.seekp(segment.Position).fail()) { stream.clear(); throw std::ios_base::failure("ストリームのシークに失敗しました。"); }
+			positioned = true;
+		}
+		if (stream.write(segment.Source, segment.Length).fail()) { stream.clear(); throw std::ios_base::failure("ストリームの書き込みに失敗しました。"); }
+		end = segment.Position + segment.Length;
+	}
+}
+std::unique_ptr<DIBLoader> DIBFileLoader::CreateReader()
+{
+	if (filename.empty()) { return nullptr; }
+	//	開き直したストリームから書き込み済みの内容が見えるよう、先に出力バッファを書き出す
+	if (!stream.bad()) { stream.flush(); stream.clear(); }
+	auto result = std::make_unique<DIBFileLoader>(filename, std::ios_base::in | std::ios_base::binary);
+	if (result->stream.fail()) { return nullptr; }
+	result->SetCache(blocksize, blockcount);
+	return result;
 }
 void DIBFileLoader::LoadHead() noexcept
 {
@@ -73,3 +129,505 @@ void DIBFileLoader::Flush() noexcept
 	(void)std::ostream::sentry(stream);
 	stream.clear();
 }
+void DIBFileLoader::ReadStream(char* dest, size_t pos, size_t length)
+{
+	if (stream.bad()) { throw InvalidOperationException("ストリームの状態が無効です。"); }
+	if (stream.tellg() != pos)
+	{
+		if (stream.seekg(pos).fail()) { stream.clear(); throw std::ios_base::failure("ストリームのシークに失敗しました。"); }
+	}
+	if (stream.read(dest, length).fail())
+	{
+		if (stream.eof()) { stream.clear(); throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
+		stream.clear();
+		throw std::ios_base::failure("ストリームの読み取りに失敗しました。");
+	}
+}
+const DIBFileLoader::CacheBlock& DIBFileLoader::FetchBlock(size_t index)
+{
+	auto found = cacheindex.find(index);
+	if (found != cacheindex.end())
+	{
+		++statistics.Hit;
+		//	最近使用したブロックを先頭に移動
+		cache.splice(cache.begin(), cache, found->second);
+		return *found->second;
+	}
+	++statistics.Miss;
+	if (stream.bad()) { throw InvalidOperationException("ストリームの状態が無効です。"); }
+	auto block = CacheBlock{ index, std::vector<char>(blocksize) };
+	if (stream.seekg(index * blocksize).fail()) { stream.clear(); throw std::ios_base::failure("ストリームのシークに失敗しました。"); }
+	if (stream.read(block.data.data(), blocksize).fail())
+	{
+		//	ストリーム終端を含むブロックは読み込めた長さに切り詰める
+		if (!stream.eof()) { stream.clear(); throw std::ios_base::failure("ストリームの読み取りに失敗しました。"); }
+		block.data.resize(size_t(stream.gcount()));
+		stream.clear();
+	}
+	//	最も長く使用されていないブロックを破棄
+	while (blockcount <= cache.size())
+	{
+		cacheindex.erase(cache.back().index);
+		cache.pop_back();
+	}
+	cache.push_front(std::move(block));
+	cacheindex.emplace(index, cache.begin());
+	return cache.front();
+}
+void DIBFileLoader::InvalidateBlocks(size_t pos, size_t length) noexcept
+{
+	if (cache.empty()||(length == 0)) { return; }
+	for (auto i: Range<size_t>(pos / blocksize, ((pos + length - 1) / blocksize) + 1).GetStdIterator())
+	{
+		auto found = cacheindex.find(i);
+		if (found == cacheindex.end()) { continue; }
+		cache.erase(found->second);
+		cacheindex.erase(found);
+	}
+}
+
+DIBMappedFileLoader::DIBMappedFileLoader() : fd(-1), data(nullptr), length(), writable(), fhead(), headersize() {}
+DIBMappedFileLoader::DIBMappedFileLoader(const char* filename, std::ios_base::openmode mode) : DIBMappedFileLoader()
+{
+	writable = (mode & std::ios_base::out) != 0;
+	fd = ::open(filename, writable ? O_RDWR : O_RDONLY);
+	if (fd < 0) { return; }
+	struct stat st;
+	if ((::fstat(fd, &st) != 0)||(st.st_size <= 0)) { Unmap(); return; }
+	void* mapped = ::mmap(nullptr, size_t(st.st_size), writable ? (PROT_READ | PROT_WRITE) : PROT_READ, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+	if (mapped == MAP_FAILED) { Unmap(); return; }
+	data = static_cast<char*>(mapped);
+	length = size_t(st.st_size);
+	LoadHead();
+}
+DIBMappedFileLoader::DIBMappedFileLoader(const std::string& filename, std::ios_base::openmode mode) : DIBMappedFileLoader(filename.c_str(), mode) {}
+DIBMappedFileLoader::DIBMappedFileLoader(DIBMappedFileLoader&& other) noexcept
+	: fd(other.fd), data(other.data), length(other.length), writable(other.writable), fhead(other.fhead), headersize(other.headersize)
+{
+	other.fd = -1;
+	other.data = nullptr;
+	other.length = 0;
+}
+DIBMappedFileLoader::~DIBMappedFileLoader() { Unmap(); }
+bool DIBMappedFileLoader::IsEnable() const { return (data != nullptr)&&(fhead.CheckFileHeader()); }
+std::iostream& DIBMappedFileLoader::Stream() { throw InvalidOperationException("このオブジェクトはストリームを持ちません。"); }
+const char* DIBMappedFileLoader::PixelData() const
+{
+	if ((data == nullptr)||(length < size_t(fhead.Offset()))) { throw InvalidDIBFormatException("ファイルヘッダのOffsetの内容が無効です。"); }
+	return data + fhead.Offset();
+}
+char* DIBMappedFileLoader::WritablePixelData()
+{
+	if (!writable) { throw InvalidOperationException("このオブジェクトは読み込み専用でマップされています。"); }
+	return const_cast<char*>(PixelData());
+}
+size_t DIBMappedFileLoader::PixelDataLength() const { return length - (PixelData() - data); }
+void DIBMappedFileLoader::Sync() noexcept
+{
+	if ((data != nullptr)&&(writable)) { (void)::msync(data, length, MS_SYNC); }
+	LoadHead();
+}
+void DIBMappedFileLoader::Read(char* dest, size_t pos, size_t length)
+{
+	if (data == nullptr) { throw InvalidOperationException("マップされた領域の状態が無効です。"); }
+	if ((this->length < pos)||((this->length - pos) < length)) { throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
+	std::memcpy(dest, data + pos, length);
+}
+const char* DIBMappedFileLoader::Peek(size_t pos, size_t length)
+{
+	if ((data == nullptr)||(this->length < pos)||((this->length - pos) < length)) { return nullptr; }
+	return data + pos;
+}
+void DIBMappedFileLoader::Write(const char* source, size_t pos, size_t length)
+{
+	if (data == nullptr) { throw InvalidOperationException("マップされた領域の状態が無効です。"); }
+	if (!writable) { throw InvalidOperationException("このオブジェクトは読み込み専用でマップされています。"); }
+	if ((this->length < pos)||((this->length - pos) < length)) { throw std::out_of_range("書き込み先の位置がマップされた領域を超えています。"); }
+	std::memcpy(data + pos, source, length);
+}
+void DIBMappedFileLoader::WriteV(const std::vector<DIBWriteSegment>& segments)
+{
+	if (data == nullptr) { throw InvalidOperationException("マップされた領域の状態が無効です。"); }
+	if (!writable) { throw InvalidOperationException("このオブジェクトは読み込み専用でマップされています。"); }
+	for (const auto& segment: segments)
+	{
+		if (segment.Length == 0) { continue; }
+		if ((length < segment.Position)||((length - segment.Position) < segment.Length)) { throw std::out_of_range("書き込み先の位置がマップされた領域を超えています。"); }
+	}
+	for (const auto& segment: segments)
+	{
+		if (segment.Length == 0) { continue; }
+		std::memcpy(data + segment.Position, segment.Source, segment.Length);
+	}
+}
+std::unique_ptr<DIBLoader> DIBMappedFileLoader::CreateReader()
+{
+	if (data == nullptr) { return nullptr; }
+	return std::make_unique<DIBMemoryLoader>((const char*)data, length);
+}
+void DIBMappedFileLoader::LoadHead() noexcept
+{
+	if ((data == nullptr)||(length < (sizeof(DIBFileHeader) + sizeof(int32_t)))) { return; }
+	std::memcpy(&fhead, data, sizeof(DIBFileHeader));
+	std::memcpy(&headersize, data + sizeof(DIBFileHeader), sizeof(int32_t));
+}
+void DIBMappedFileLoader::Unmap() noexcept
+{
+	if (data != nullptr) { (void)::munmap(data, length); }
+	if (0 <= fd) { (void)::close(fd); }
+	fd = -1;
+	data = nullptr;
+	length = 0;
+}
+
+DIBPositionalFileLoader::DIBPositionalFileLoader() : fd(-1), writable(), fhead(), headersize() {}
+DIBPositionalFileLoader::DIBPositionalFileLoader(const char* filename, std::ios_base::openmode mode) : DIBPositionalFileLoader()
+{
+	writable = (mode & std::ios_base::out) != 0;
+	auto flags = writable ? O_RDWR : O_RDONLY;
+	//	std::fstream と同様に、入力を伴わない出力または切り詰めの指定ではファイルを作成する
+	if (writable && (((mode & std::ios_base::in) == 0)||((mode & std::ios_base::trunc) != 0))) { flags |= O_CREAT | O_TRUNC; }
+	fd = ::open(filename, flags | O_CLOEXEC, 0666);
+	if (fd < 0) { return; }
+	LoadHead();
+}
+DIBPositionalFileLoader::DIBPositionalFileLoader(const std::string& filename, std::ios_base::openmode mode) : DIBPositionalFileLoader(filename.c_str(), mode) {}
+DIBPositionalFileLoader::DIBPositionalFileLoader(DIBPositionalFileLoader&& other) noexcept
+	: fd(other.fd), writable(other.writable), fhead(other.fhead), headersize(other.headersize)
+{
+	other.fd = -1;
+}
+DIBPositionalFileLoader::~DIBPositionalFileLoader() { Close(); }
+bool DIBPositionalFileLoader::IsEnable() const { return (0 <= fd)&&(fhead.CheckFileHeader()); }
+std::iostream& DIBPositionalFileLoader::Stream() { throw InvalidOperationException("このオブジェクトはストリームを持ちません。"); }
+void DIBPositionalFileLoader::Sync() noexcept { LoadHead(); }
+void DIBPositionalFileLoader::Read(char* dest, size_t pos, size_t length)
+{
+	if (fd < 0) { throw InvalidOperationException("ファイルの状態が無効です。"); }
+	while (0 < length)
+	{
+		auto result = ::pread(fd, dest, length, off_t(pos));
+		if (result < 0)
+		{
+			if (errno == EINTR) { continue; }
+			throw std::ios_base::failure("ファイルの読み取りに失敗しました。");
+		}
+		if (result == 0) { throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
+		dest += result;
+		pos += size_t(result);
+		length -= size_t(result);
+	}
+}
+void DIBPositionalFileLoader::Write(const char* source, size_t pos, size_t length)
+{
+	if (fd < 0) { throw InvalidOperationException("ファイルの状態が無効です。"); }
+	if (!writable) { throw InvalidOperationException("このオブジェクトは読み込み専用で開かれています。"); }
+	while (0 < length)
+	{
+		auto result = ::pwrite(fd, source, length, off_t(pos));
+		if (result < 0)
+		{
+			if (errno == EINTR) { continue; }
+			throw std::ios_base::failure("ファイルの書き込みに失敗しました。");
+		}
+		if (result == 0) { throw std::ios_base::failure("ファイルの書き込みが進みませんでした。"); }
+		source += result;
+		pos += size_t(result);
+		length -= size_t(result);
+	}
+}
+void DIBPositionalFileLoader::WriteV(const std::vector<DIBWriteSegment>& segments)
+{
+	if (fd < 0) { throw InvalidOperationException("ファイルの状態が無効です。"); }
+	if (!writable) { throw InvalidOperationException("このオブジェクトは読み込み専用で開かれています。"); }
+	auto vectors = std::vector<iovec>();
+	vectors.reserve(std::min(segments.size(), size_t(IOV_MAX)));
+	auto i = size_t(0U);
+	while (i < segments.size())
+	{
+		//	位置が連続する領域を1回の書き込みにまとめる
+		auto pos = segments[i].Position;
+		auto end = pos;
+		vectors.clear();
+		while ((i < segments.size())&&(segments[i].Position == end)&&(vectors.size() < size_t(IOV_MAX)))
+		{
+			if (0 < segments[i].Length) { vectors.push_back(iovec{ (void*)segments[i].Source, segments[i].Length }); }
+			end += segments[i].Length;
+			++i;
+		}
+		auto current = vectors.data();
+		auto count = vectors.size();
+		while (0 < count)
+		{
+			auto result = ::pwritev(fd, current, int(count), off_t(pos));
+			if (result < 0)
+			{
+				if (errno == EINTR) { continue; }
+				throw std::ios_base::failure("ファイルの書き込みに失敗しました。");
+			}
+			if (result == 0) { throw std::ios_base::failure("ファイルの書き込みが進みませんでした。"); }
+			pos += size_t(result);
+			//	途中まで書き込まれた場合は、残りの領域から再開する
+			auto rest = size_t(result);
+			while ((0 < count)&&(current->iov_len <= rest)) { rest -= current->iov_len; ++current; --count; }
+			if (0 < count) { current->iov_base = (char*)current->iov_base + rest; current->iov_len -= rest; }
+		}
+	}
+}
+std::unique_ptr<DIBLoader> DIBPositionalFileLoader::CreateReader()
+{
+	if (fd < 0) { return nullptr; }
+	//	位置指定の読み込みはファイルの読み込み位置を使用しないため、複製した記述子を共有しても干渉しない
+	auto result = std::make_unique<DIBPositionalFileLoader>();
+	result->fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+	if (result->fd < 0) { return nullptr; }
+	result->fhead = fhead;
+	result->headersize = headersize;
+	return result;
+}
+void DIBPositionalFileLoader::LoadHead() noexcept
+{
+	if (fd < 0) { return; }
+	char head[sizeof(DIBFileHeader) + sizeof(int32_t)];
+	try { Read(head, 0, sizeof(head)); }
+	catch (...) { return; }
+	std::memcpy(&fhead, head, sizeof(DIBFileHeader));
+	std::memcpy(&headersize, head + sizeof(DIBFileHeader), sizeof(int32_t));
+}
+void DIBPositionalFileLoader::Close() noexcept
+{
+	if (0 <= fd) { (void)::close(fd); }
+	fd = -1;
+}
+
+DIBMemoryLoader::DIBMemoryLoader() : buffer(), external(nullptr), externallength(), writable(true), fhead(), headersize() {}
+DIBMemoryLoader::DIBMemoryLoader(std::vector<char>&& buffer) : buffer(std::move(buffer)), external(nullptr), externallength(), writable(true), fhead(), headersize() { LoadHead(); }
+DIBMemoryLoader::DIBMemoryLoader(char* data, size_t length) : buffer(), external(data), externallength(length), writable(true), fhead(), headersize()
+{
+	if (data == nullptr) { throw std::invalid_argument("dataにnullptrを指定することはできません。"); }
+	LoadHead();
+}
+DIBMemoryLoader::DIBMemoryLoader(const char* data, size_t length) : DIBMemoryLoader(const_cast<char*>(data), length) { writable = false; }
+bool DIBMemoryLoader::IsEnable() const { return fhead.CheckFileHeader(); }
+std::iostream& DIBMemoryLoader::Stream() { throw InvalidOperationException("このオブジェクトはストリームを持ちません。"); }
+const char* DIBMemoryLoader::Data() const { return (external != nullptr)?(external):(buffer.data()); }
+size_t DIBMemoryLoader::Length() const { return (external != nullptr)?(externallength):(buffer.size()); }
+const std::vector<char>& DIBMemoryLoader::Buffer() const
+{
+	if (external != nullptr) { throw InvalidOperationException("このオブジェクトは呼び出し元の領域を参照しています。"); }
+	return buffer;
+}
+void DIBMemoryLoader::Sync() noexcept { LoadHead(); }
+void DIBMemoryLoader::Read(char* dest, size_t pos, size_t length)
+{
+	auto total = Length();
+	if ((total < pos)||((total - pos) < length)) { throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
+	std::memcpy(dest, Data() + pos, length);
+}
+const char* DIBMemoryLoader::Peek(size_t pos, size_t length)
+{
+	auto total = Length();
+	if ((Data() == nullptr)||(total < pos)||((total - pos) < length)) { return nullptr; }
+	return Data() + pos;
+}
+void DIBMemoryLoader::Write(const char* source, size_t pos, size_t length)
+{
+	if (!writable) { throw InvalidOperationException("このオブジェクトは読み込み専用の領域を参照しています。"); }
+	if (external != nullptr)
+	{
+		if ((externallength < pos)||((externallength - pos) < length)) { throw std::out_of_range("書き込み先の位置が参照している領域を超えています。"); }
+		std::memcpy(external + pos, source, length);
+	}
+	else
+	{
+		if (buffer.size() < (pos + length)) { buffer.resize(pos + length); }
+		std::memcpy(buffer.data() + pos, source, length);
+	}
+}
+std::unique_ptr<DIBLoader> DIBMemoryLoader::CreateReader()
+{
+	if (Data() == nullptr) { return nullptr; }
+	return std::make_unique<DIBMemoryLoader>(Data(), Length());
+}
+void DIBMemoryLoader::LoadHead() noexcept
+{
+	if (Length() < (sizeof(DIBFileHeader) + sizeof(int32_t))) { return; }
+	std::memcpy(&fhead, Data(), sizeof(DIBFileHeader));
+	std::memcpy(&headersize, Data() + sizeof(DIBFileHeader), sizeof(int32_t));
+}
+DIBStreamLoader::DIBStreamLoader(std::istream& stream) : stream(&stream), fd(-1), fhead(), headersize(), position(0) { LoadHead(); }
+DIBStreamLoader::DIBStreamLoader(int fd) : stream(nullptr), fd(fd), fhead(), headersize(), position(0) { LoadHead(); }
+bool DIBStreamLoader::IsEnable() const { return fhead.CheckFileHeader(); }
+std::iostream& DIBStreamLoader::Stream() { throw InvalidOperationException("このオブジェクトは入出力両用のストリームを持ちません。"); }
+void DIBStreamLoader::Sync() noexcept {}
+void DIBStreamLoader::Read(char* dest, size_t pos, size_t length)
+{
+	//	構築時に読み込んだ範囲は保持しているヘッダから返す
+	constexpr size_t headlength = sizeof(DIBFileHeader) + sizeof(int32_t);
+	if (pos < headlength)
+	{
+		char head[headlength];
+		std::memcpy(head, &fhead, sizeof(DIBFileHeader));
+		std::memcpy(head + sizeof(DIBFileHeader), &headersize, sizeof(int32_t));
+		auto count = std::min(length, headlength - pos);
+		if (position < pos + count) { throw InvalidOperationException("ヘッダが読み込まれていません。"); }
+		std::memcpy(dest, head + pos, count);
+		dest += count;
+		pos += count;
+		length -= count;
+		if (length == 0) { return; }
+	}
+	if (pos < position) { throw InvalidOperationException("読み込み済みの位置に戻ることはできません。"); }
+	Skip(pos - position);
+	auto count = ReadSource(dest, length);
+	position += count;
+	if (count < length) { throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
+}
+void DIBStreamLoader::Write(const char*, size_t, size_t) { throw InvalidOperationException("このオブジェクトは読み込み専用です。"); }
+void DIBStreamLoader::LoadHead() noexcept
+{
+	try
+	{
+		if (ReadSource((char*)&fhead, sizeof(DIBFileHeader)) != sizeof(DIBFileHeader)) { fhead = DIBFileHeader(); return; }
+		position += sizeof(DIBFileHeader);
+		if (ReadSource((char*)&headersize, sizeof(int32_t)) != sizeof(int32_t)) { fhead = DIBFileHeader(); return; }
+		position += sizeof(int32_t);
+	}
+	catch (...) { fhead = DIBFileHeader(); }
+}
+size_t DIBStreamLoader::ReadSource(char* dest, size_t length)
+{
+	if (stream != nullptr)
+	{
+		if (stream->bad()) { throw InvalidOperationException("ストリームの状態が無効です。"); }
+		stream->read(dest, length);
+		auto count = size_t(stream->gcount());
+		if (stream->fail() && !stream->eof()) { stream->clear(); throw std::ios_base::failure("ストリームの読み取りに失敗しました。"); }
+		return count;
+	}
+	size_t count = 0;
+	while (count < length)
+	{
+		auto result = ::read(fd, dest + count, length - count);
+		if (result < 0)
+		{
+			if (errno == EINTR) { continue; }
+			throw std::ios_base::failure("ファイルの読み取りに失敗しました。");
+		}
+		if (result == 0) { break; }
+		count += size_t(result);
+	}
+	return count;
+}
+void DIBStreamLoader::Skip(size_t length)
+{
+	//	シークできないため、読み込んで破棄する
+	char discard[4096];
+	while (0 < length)
+	{
+		auto count = ReadSource(discard, std::min(length, sizeof(discard)));
+		position += count;
+		if (count == 0) { throw InvalidDIBFormatException("データの読み取り中にストリーム終端に到達しました。"); }
+		length -= count;
+	}
+}
+DIBOutputStreamLoader::DIBOutputStreamLoader(std::ostream& stream) : stream(&stream), fd(-1), fhead(), headersize(), position(0) {}
+DIBOutputStreamLoader::DIBOutputStreamLoader(int fd) : stream(nullptr), fd(fd), fhead(), headersize(), position(0) {}
+bool DIBOutputStreamLoader::IsEnable() const { return fhead.CheckFileHeader(); }
+std::iostream& DIBOutputStreamLoader::Stream() { throw InvalidOperationException("このオブジェクトは入出力両用のストリームを持ちません。"); }
+void DIBOutputStreamLoader::Sync() noexcept
+{
+	if ((stream != nullptr)&&(!stream->bad())) { stream->flush(); }
+}
+void DIBOutputStreamLoader::Read(char*, size_t, size_t) { throw InvalidOperationException("このオブジェクトは書き込み専用です。"); }
+void DIBOutputStreamLoader::Write(const char* source, size_t pos, size_t length)
+{
+	if (pos < position) { throw InvalidOperationException("書き込み済みの位置に戻ることはできません。"); }
+	//	シークできないため、間の領域は0で埋める
+	const char zero[4096] = {};
+	while (position < pos) { WriteSink(zero, std::min(pos - position, sizeof(zero))); }
+	CaptureHead(source, pos, length);
+	WriteSink(source, length);
+}
+void DIBOutputStreamLoader::WriteV(const std::vector<DIBWriteSegment>& segments)
+{
+	auto end = position;
+	auto contiguous = true;
+	for (const auto& segment: segments)
+	{
+		if (segment.Position != end) { contiguous = false; break; }
+		end += segment.Length;
+	}
+	//	ストリームへの書き込みはバッファされ、間の領域は0で埋める必要があるため、これらの場合は領域ごとに書き込む
+	if ((stream != nullptr)||(!contiguous))
+	{
+		DIBLoader::WriteV(segments);
+		return;
+	}
+	auto vectors = std::vector<iovec>();
+	vectors.reserve(std::min(segments.size(), size_t(IOV_MAX)));
+	auto i = size_t(0U);
+	while (i < segments.size())
+	{
+		vectors.clear();
+		while ((i < segments.size())&&(vectors.size() < size_t(IOV_MAX)))
+		{
+			CaptureHead(segments[i].Source, segments[i].Position, segments[i].Length);
+			if (0 < segments[i].Length) { vectors.push_back(iovec{ (void*)segments[i].Source, segments[i].Length }); }
+			++i;
+		}
+		auto current = vectors.data();
+		auto count = vectors.size();
+		while (0 < count)
+		{
+			auto result = ::writev(fd, current, int(count));
+			if (result < 0)
+			{
+				if (errno == EINTR) { continue; }
+				throw std::ios_base::failure("ファイルの書き込みに失敗しました。");
+			}
+			if (result == 0) { throw std::ios_base::failure("ファイルの書き込みが進みませんでした。"); }
+			position += size_t(result);
+			//	途中まで書き込まれた場合は、残りの領域から再開する
+			auto rest = size_t(result);
+			while ((0 < count)&&(current->iov_len <= rest)) { rest -= current->iov_len; ++current; --count; }
+			if (0 < count) { current->iov_base = (char*)current->iov_base + rest; current->iov_len -= rest; }
+		}
+	}
+}
+void DIBOutputStreamLoader::CaptureHead(const char* source, size_t pos, size_t length) noexcept
+{
+	//	ファイルヘッダと情報ヘッダのサイズは書き込まれた内容を保持する
+	constexpr size_t headlength = sizeof(DIBFileHeader) + sizeof(int32_t);
+	if (headlength <= pos) { return; }
+	auto count = std::min(length, headlength - pos);
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		auto p = pos + i;
+		if (p < sizeof(DIBFileHeader)) { ((char*)&fhead)[p] = source[i]; }
+		else { ((char*)&headersize)[p - sizeof(DIBFileHeader)] = source[i]; }
+	}
+}
+void DIBOutputStreamLoader::WriteSink(const char* source, size_t length)
+{
+	if (stream != nullptr)
+	{
+		if (stream->bad()) { throw InvalidOperationException("ストリームの状態が無効です。"); }
+		if (stream->write(source, length).fail()) { stream->clear(); throw std::ios_base::failure("ストリームの書き込みに失敗しました。"); }
+		position += length;
+		return;
+	}
+	size_t count = 0;
+	while (count < length)
+	{
+		auto result = ::write(fd, source + count, length - count);
+		if (result < 0)
+		{
+			if (errno == EINTR) { continue; }
+			throw std::ios_base::failure("ファイルの書き込みに失敗しました。");
+		}
+		if (result == 0) { throw std::ios_base::failure("ファイルの書き込みが進みませんでした。"); }
+		count += size_t(result);
+	}
+	position += length;
+}
@@ -0,0 +1,99 @@
+//	stationaryorbit.graphics-dib:/dibpushdecoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include "stationaryorbit/graphics-dib/dibpushdecoder.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+DIBPushDecoder::DIBPushDecoder(const RowHandler& handler, size_t maxstridelength) : handler(handler), maxstridelength(maxstridelength), format(), head(), pending(), row(), position(0), decoded(0), failed(false) {}
+const DIBScanlineFormat& DIBPushDecoder::Format() const
+{
+	if (!format.has_value()) { throw InvalidOperationException("ヘッダの読み込みが完了していません。"); }
+	return *format;
+}
+void DIBPushDecoder::Feed(const char* data, size_t length)
+{
+	if (failed) { throw InvalidOperationException("以前の呼び出しで例外が発生しています。"); }
+	try
+	{
+		auto consume = [&](size_t count) { data += count; length -= count; position += count; };
+		while ((0 < length)&&(!IsCompleted()))
+		{
+			if (!format.has_value())
+			{
+				//	ヘッダに必要な長さはデータが揃うにつれて確定するため、確定した長さの分だけ保持する
+				auto required = DIBScanlineFormat::HeadLength(head.data(), head.size());
+				if (head.size() < required)
+				{
+					auto count = std::min(length, required - head.size());
+					head.insert(head.end(), data, data + count);
+					consume(count);
+				}
+				if (DIBScanlineFormat::HeadLength(head.data(), head.size()) <= head.size()) { LoadHead(); }
+				continue;
+			}
+			if (position < format->Offset)
+			{
+				//	ピクセル配列までの間のデータは読み捨てる
+				consume(std::min(length, format->Offset - position));
+				continue;
+			}
+			auto stridelength = format->StrideLength;
+			if ((pending.empty())&&(stridelength <= length))
+			{
+				//	水平ライン全体が渡されたデータに含まれている場合は、コピーせずにデコードする
+				DecodeRow((const uint8_t*)data);
+				consume(stridelength);
+				continue;
+			}
+			auto count = std::min(length, stridelength - pending.size());
+			pending.insert(pending.end(), (const uint8_t*)data, (const uint8_t*)data + count);
+			consume(count);
+			if (pending.size() == stridelength)
+			{
+				DecodeRow(pending.data());
+				pending.clear();
+			}
+		}
+	}
+	catch (...)
+	{
+		failed = true;
+		throw;
+	}
+}
+void DIBPushDecoder::LoadHead()
+{
+	auto loader = DIBMemoryLoader((const char*)head.data(), head.size());
+	if (!loader.IsEnable()) { throw InvalidDIBFormatException("ファイルヘッダの内容が無効です。"); }
+	auto loaded = DIBScanlineFormat::Load(loader, maxstridelength);
+	if (loaded.Offset < head.size()) { throw InvalidDIBFormatException("ピクセル配列の位置がヘッダと重なっています。"); }
+	row.resize(loaded.Size.Width());
+	pending.reserve(loaded.StrideLength);
+	format = std::move(loaded);
+	//	ヘッダの内容は以降使用しないため破棄する
+	head = std::vector<char>();
+}
+void DIBPushDecoder::DecodeRow(const uint8_t* data)
+{
+	format->Converter.Convert(data, row.data(), format->Size.Width());
+	auto y = format->ResolveY(decoded);
+	++decoded;
+	handler(y, row.data());
+}
@@ -0,0 +1,60 @@
+//	stationaryorbit.graphics-dib:/dibrowbatch
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include <stdexcept>
+#include "stationaryorbit/graphics-dib/dibrowbatch.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+DIBRowBatch::DIBRowBatch(DIBLoader& loader, size_t offset, const DisplayRectSize& size, size_t stridelength, size_t batchrows)
+	: loader(loader), offset(offset), width(size.Width()), length(int64_t(size.Width()) * size.Height()), stridelength(stridelength), batchrows(batchrows), rowbuffer(), bufferrow(0)
+{
+	if (batchrows == 0) { throw std::invalid_argument("batchrowsに0を指定することはできません。"); }
+	rowbuffer.resize(stridelength * batchrows);
+}
+uint8_t* DIBRowBatch::Row(int64_t current) { return rowbuffer.data() + (stridelength * size_t((current / width) - bufferrow)); }
+void DIBRowBatch::Advance(int64_t current)
+{
+	//	水平ラインの末尾に達し、バッファが埋まったか画像の末尾に達した場合に書き込む
+	if ((current % width) != 0) { return; }
+	if ((size_t((current / width) - bufferrow) == batchrows)||(length <= current)) { Flush(current); }
+}
+void DIBRowBatch::Flush(int64_t current)
+{
+	if (width <= 0) { return; }
+	//	書き込み途中の水平ラインを含めたバッファ内の行数
+	auto rows = ((current + width - 1) / width) - bufferrow;
+	if (rows <= 0) { return; }
+	loader.Write((const char*)rowbuffer.data(), offset + (stridelength * bufferrow), stridelength * rows);
+	auto completed = current / width;
+	if ((completed - bufferrow) < rows)
+	{
+		//	書き込み途中の水平ラインはバッファの先頭に移して続きを受け付ける
+		auto partial = rowbuffer.begin() + (stridelength * (rows - 1));
+		std::copy(partial, partial + stridelength, rowbuffer.begin());
+		std::fill(rowbuffer.begin() + stridelength, rowbuffer.end(), uint8_t());
+	}
+	else { std::fill(rowbuffer.begin(), rowbuffer.end(), uint8_t()); }
+	bufferrow = completed;
+}
+void DIBRowBatch::Reset()
+{
+	std::fill(rowbuffer.begin(), rowbuffer.end(), uint8_t());
+	bufferrow = 0;
+}
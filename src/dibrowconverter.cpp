@@ -0,0 +1,655 @@
+//	stationaryorbit.graphics-dib:/dibrowconverter
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include "stationaryorbit/graphics-dib/dibrowconverter.hpp"
+#include "stationaryorbit/graphics-dib/invaliddibformat.hpp"
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define __stationaryorbit_graphics_dib_x86_kernels__
+#include <immintrin.h>
+#endif
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+namespace
+{
+	///	バイト列の変換を行う関数の型。
+	///	@a dest は @a RGB8_t 1ピクセルあたり R, G, B の3バイトが並ぶ配置です。
+	typedef void (*RowKernel)(const uint8_t* src, uint8_t* dest, size_t count);
+	///	参照テーブルを使用してインデックスの変換を行う関数の型。
+	///	@a table の各要素は下位バイトから R, G, B の順に色を格納しています。
+	typedef void (*IndexKernel)(const uint8_t* src, uint8_t* dest, size_t count, const uint32_t* table);
+
+	void ScalarBGR24(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			dest[i * 3 + 0] = src[i * 3 + 2];
+			dest[i * 3 + 1] = src[i * 3 + 1];
+			dest[i * 3 + 2] = src[i * 3 + 0];
+		}
+	}
+	void ScalarBGRX32(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			dest[i * 3 + 0] = src[i * 4 + 2];
+			dest[i * 3 + 1] = src[i * 4 + 1];
+			dest[i * 3 + 2] = src[i * 4 + 0];
+		}
+	}
+	constexpr uint8_t Expand5(uint32_t value) { return uint8_t(DIBPixelPerser::Expand5(value)); }
+	constexpr uint8_t Expand6(uint32_t value) { return uint8_t(DIBPixelPerser::Expand6(value)); }
+	void ScalarRGB555(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t v = src[i * 2] | (uint32_t(src[i * 2 + 1]) << 8);
+			dest[i * 3 + 0] = Expand5((v >> 10) & 0x1F);
+			dest[i * 3 + 1] = Expand5((v >> 5) & 0x1F);
+			dest[i * 3 + 2] = Expand5(v & 0x1F);
+		}
+	}
+	void ScalarRGB565(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t v = src[i * 2] | (uint32_t(src[i * 2 + 1]) << 8);
+			dest[i * 3 + 0] = Expand5((v >> 11) & 0x1F);
+			dest[i * 3 + 1] = Expand6((v >> 5) & 0x3F);
+			dest[i * 3 + 2] = Expand5(v & 0x1F);
+		}
+	}
+	void ScalarPackRGB555(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t v = ((src[i * 3 + 0] & 0xF8) << 7) | ((src[i * 3 + 1] & 0xF8) << 2) | (src[i * 3 + 2] >> 3);
+			dest[i * 2 + 0] = uint8_t(v);
+			dest[i * 2 + 1] = uint8_t(v >> 8);
+		}
+	}
+	void ScalarPackRGB565(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t v = ((src[i * 3 + 0] & 0xF8) << 8) | ((src[i * 3 + 1] & 0xFC) << 3) | (src[i * 3 + 2] >> 3);
+			dest[i * 2 + 0] = uint8_t(v);
+			dest[i * 2 + 1] = uint8_t(v >> 8);
+		}
+	}
+	void ScalarIndexed8(const uint8_t* src, uint8_t* dest, size_t count, const uint32_t* table)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			auto v = table[src[i]];
+			dest[i * 3 + 0] = uint8_t(v);
+			dest[i * 3 + 1] = uint8_t(v >> 8);
+			dest[i * 3 + 2] = uint8_t(v >> 16);
+		}
+	}
+#ifdef __stationaryorbit_graphics_dib_x86_kernels__
+	//	SSE2 にはバイト単位のシャッフル命令が無いため、ベクトル化は SSSE3 以降で行います。
+	//	ストアは有効なバイトより長く書き込むため、ループ条件で書き込み先の残りの長さを確保しています。
+
+	__attribute__((target("ssse3")))
+	void SSSE3BGR24(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		// 1回のロードで5ピクセル(15バイト)を変換
+		const auto mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, -1);
+		size_t i = 0;
+		for (; (count - i) >= 6; i += 5)
+		{
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 3), _mm_shuffle_epi8(v, mask));
+		}
+		ScalarBGR24(src + i * 3, dest + i * 3, count - i);
+	}
+	__attribute__((target("ssse3")))
+	void SSSE3BGRX32(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		// 1回のロードで4ピクセル(16バイト→12バイト)を変換
+		const auto mask = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		size_t i = 0;
+		for (; (count - i) >= 6; i += 4)
+		{
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 3), _mm_shuffle_epi8(v, mask));
+		}
+		ScalarBGRX32(src + i * 4, dest + i * 3, count - i);
+	}
+	///	16ビット幅の要素に格納された8ピクセル分の各チャネルを R, G, B の24バイトに並べて格納します。
+	__attribute__((target("ssse3")))
+	inline void StoreInterleaved8(__m128i r, __m128i g, __m128i b, uint8_t* dest)
+	{
+		// x: R0..R7 G0..G7, y: B0..B7
+		auto x = _mm_packus_epi16(r, g);
+		auto y = _mm_packus_epi16(b, _mm_setzero_si128());
+		auto lo = _mm_or_si128(
+			_mm_shuffle_epi8(x, _mm_setr_epi8(0, 8, -1, 1, 9, -1, 2, 10, -1, 3, 11, -1, 4, 12, -1, 5)),
+			_mm_shuffle_epi8(y, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+		auto hi = _mm_or_si128(
+			_mm_shuffle_epi8(x, _mm_setr_epi8(13, -1, 6, 14, -1, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+			_mm_shuffle_epi8(y, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), lo);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dest + 16), hi);
+	}
+	///	R, G, B の24バイトに並んだ8ピクセル分の各チャネルを16ビット幅の要素に展開します。
+	__attribute__((target("ssse3")))
+	inline void LoadDeinterleaved8(const uint8_t* src, __m128i& r, __m128i& g, __m128i& b)
+	{
+		auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		auto hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 16));
+		r = _mm_or_si128(
+			_mm_shuffle_epi8(lo, _mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, 12, -1, 15, -1, -1, -1, -1, -1)),
+			_mm_shuffle_epi8(hi, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, -1, 5, -1)));
+		g = _mm_or_si128(
+			_mm_shuffle_epi8(lo, _mm_setr_epi8(1, -1, 4, -1, 7, -1, 10, -1, 13, -1, -1, -1, -1, -1, -1, -1)),
+			_mm_shuffle_epi8(hi, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, -1, 3, -1, 6, -1)));
+		b = _mm_or_si128(
+			_mm_shuffle_epi8(lo, _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1)),
+			_mm_shuffle_epi8(hi, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1)));
+	}
+	__attribute__((target("ssse3")))
+	void SSSE3RGB555(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		const auto mask5 = _mm_set1_epi16(0x1F);
+		size_t i = 0;
+		for (; (count - i) >= 8; i += 8)
+		{
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+			auto r = _mm_and_si128(_mm_srli_epi16(v, 10), mask5);
+			auto g = _mm_and_si128(_mm_srli_epi16(v, 5), mask5);
+			auto b = _mm_and_si128(v, mask5);
+			StoreInterleaved8(
+				_mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2)),
+				_mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2)),
+				_mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2)),
+				dest + i * 3);
+		}
+		ScalarRGB555(src + i * 2, dest + i * 3, count - i);
+	}
+	__attribute__((target("ssse3")))
+	void SSSE3RGB565(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		const auto mask5 = _mm_set1_epi16(0x1F);
+		const auto mask6 = _mm_set1_epi16(0x3F);
+		size_t i = 0;
+		for (; (count - i) >= 8; i += 8)
+		{
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+			auto r = _mm_srli_epi16(v, 11);
+			auto g = _mm_and_si128(_mm_srli_epi16(v, 5), mask6);
+			auto b = _mm_and_si128(v, mask5);
+			StoreInterleaved8(
+				_mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2)),
+				_mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4)),
+				_mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2)),
+				dest + i * 3);
+		}
+		ScalarRGB565(src + i * 2, dest + i * 3, count - i);
+	}
+	__attribute__((target("ssse3")))
+	void SSSE3PackRGB555(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		const auto mask = _mm_set1_epi16(0xF8);
+		size_t i = 0;
+		for (; (count - i) >= 8; i += 8)
+		{
+			__m128i r, g, b;
+			LoadDeinterleaved8(src + i * 3, r, g, b);
+			auto v = _mm_or_si128(
+				_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r, mask), 7), _mm_slli_epi16(_mm_and_si128(g, mask), 2)),
+				_mm_srli_epi16(b, 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 2), v);
+		}
+		ScalarPackRGB555(src + i * 3, dest + i * 2, count - i);
+	}
+	__attribute__((target("ssse3")))
+	void SSSE3PackRGB565(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		const auto mask5 = _mm_set1_epi16(0xF8);
+		const auto mask6 = _mm_set1_epi16(0xFC);
+		size_t i = 0;
+		for (; (count - i) >= 8; i += 8)
+		{
+			__m128i r, g, b;
+			LoadDeinterleaved8(src + i * 3, r, g, b);
+			auto v = _mm_or_si128(
+				_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r, mask5), 8), _mm_slli_epi16(_mm_and_si128(g, mask6), 3)),
+				_mm_srli_epi16(b, 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 2), v);
+		}
+		ScalarPackRGB565(src + i * 3, dest + i * 2, count - i);
+	}
+	__attribute__((target("avx2")))
+	void AVX2BGR24(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		// 各レーンで5ピクセルずつ、1回あたり10ピクセル(30バイト)を変換
+		const auto mask = _mm256_setr_epi8(
+			2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, -1,
+			2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, -1);
+		size_t i = 0;
+		for (; (count - i) >= 11; i += 10)
+		{
+			auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+			auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 15));
+			auto v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), mask);
+			// 下位レーンの16バイト目は上位レーンのストアで上書きされる
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 3), _mm256_castsi256_si128(v));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 3 + 15), _mm256_extracti128_si256(v, 1));
+		}
+		SSSE3BGR24(src + i * 3, dest + i * 3, count - i);
+	}
+	__attribute__((target("avx2")))
+	void AVX2BGRX32(const uint8_t* src, uint8_t* dest, size_t count)
+	{
+		// 1回のロードで8ピクセル(32バイト→24バイト)を変換
+		const auto mask = _mm256_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		const auto pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+		size_t i = 0;
+		for (; (count - i) >= 11; i += 8)
+		{
+			auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+			v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, mask), pack);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * 3), v);
+		}
+		SSSE3BGRX32(src + i * 4, dest + i * 3, count - i);
+	}
+	__attribute__((target("avx2")))
+	void AVX2Indexed8(const uint8_t* src, uint8_t* dest, size_t count, const uint32_t* table)
+	{
+		// 1回のギャザーで8ピクセル(32バイト→24バイト)を変換
+		const auto mask = _mm256_setr_epi8(
+			0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+			0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		const auto pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+		size_t i = 0;
+		for (; (count - i) >= 11; i += 8)
+		{
+			auto index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+			auto v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), index, 4);
+			v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, mask), pack);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * 3), v);
+		}
+		ScalarIndexed8(src + i, dest + i * 3, count - i, table);
+	}
+#endif
+
+	///	ビットフィールド形式のピクセルデータを色に変換します。
+	///	@param	T
+	///	1ピクセルのデータの型。
+	template<class T>
+	void ConvertMasked(const uint8_t* src, RGB8_t* dest, size_t count, const DIBBitFields& bitfields)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			auto data = uint32_t();
+			for (size_t b = 0; b < sizeof(T); b++) { data |= uint32_t(src[i * sizeof(T) + b]) << (b * 8); }
+			dest[i] = bitfields.ToRGB(data);
+		}
+	}
+
+	///	実行環境に合わせて選択された変換関数の組。
+	struct RowKernelSet
+	{
+		RowKernel BGR24;
+		RowKernel BGRX32;
+		RowKernel RGB555;
+		RowKernel RGB565;
+		RowKernel PackRGB555;
+		RowKernel PackRGB565;
+		IndexKernel Indexed8;
+		const char* Name;
+	};
+	///	@a RGB8_t が R, G, B の3バイトの並びとして扱えるかを確認します。
+	bool IsByteLayoutCompatible()
+	{
+		if (sizeof(RGB8_t) != 3) { return false; }
+		const uint8_t bytes[3] = { 0x30, 0x60, 0x90 };
+		auto data = RGBTriple_t();
+		std::memcpy(&data, bytes, sizeof(RGBTriple_t));
+		auto color = RGB8_t(data);
+		uint8_t result[3];
+		std::memcpy(result, &color, sizeof(result));
+		return (result[0] == bytes[2]) && (result[1] == bytes[1]) && (result[2] == bytes[0]);
+	}
+	RowKernelSet SelectScalarKernels()
+	{
+		if (!IsByteLayoutCompatible()) { return RowKernelSet{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "generic" }; }
+		return RowKernelSet{ ScalarBGR24, ScalarBGRX32, ScalarRGB555, ScalarRGB565, ScalarPackRGB555, ScalarPackRGB565, ScalarIndexed8, "scalar" };
+	}
+	RowKernelSet SelectKernels()
+	{
+		if (!IsByteLayoutCompatible()) { return SelectScalarKernels(); }
+#ifdef __stationaryorbit_graphics_dib_x86_kernels__
+		__builtin_cpu_init();
+		//	16ビットの変換は並べ替えが律速となるため、AVX2 環境でも SSSE3 の実装を使用する
+		if (__builtin_cpu_supports("avx2")) { return RowKernelSet{ AVX2BGR24, AVX2BGRX32, SSSE3RGB555, SSSE3RGB565, SSSE3PackRGB555, SSSE3PackRGB565, AVX2Indexed8, "avx2" }; }
+		if (__builtin_cpu_supports("ssse3")) { return RowKernelSet{ SSSE3BGR24, SSSE3BGRX32, SSSE3RGB555, SSSE3RGB565, SSSE3PackRGB555, SSSE3PackRGB565, ScalarIndexed8, "ssse3" }; }
+#endif
+		return SelectScalarKernels();
+	}
+	///	選択済みの変換関数を取得します。
+	///	初回の呼び出し時にのみ実行環境の判定が行われます。
+	const RowKernelSet& Kernels()
+	{
+		static const RowKernelSet kernels = SelectKernels();
+		return kernels;
+	}
+	///	指定された実装の変換関数を取得します。
+	const RowKernelSet& Kernels(DIBRowConverter::KernelSelection selection)
+	{
+		static const RowKernelSet scalar = SelectScalarKernels();
+		return (selection == DIBRowConverter::KernelSelection::Scalar)?(scalar):(Kernels());
+	}
+}
+
+DIBRowConverter::DIBRowConverter() : bitdepth(DIBBitDepth::Null), palette(), unpacktable(), indextable(), bitfields() {}
+DIBRowConverter::DIBRowConverter(DIBBitDepth bitdepth) : bitdepth(bitdepth), palette(), unpacktable(), indextable(), bitfields()
+{
+	switch(bitdepth)
+	{
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		case DIBBitDepth::Bit8:
+		{ throw std::invalid_argument("インデックスカラーの変換には色パレットが必要です。"); }
+		default: { break; }
+	}
+}
+DIBRowConverter::DIBRowConverter(DIBBitDepth bitdepth, const std::vector<RGB8_t>& palette) : bitdepth(bitdepth), palette(palette), unpacktable(), indextable(), bitfields() { BuildUnpackTable(); BuildIndexTable(); }
+DIBRowConverter::DIBRowConverter(DIBBitDepth bitdepth, const DIBBitFields& bitfields) : bitdepth(bitdepth), palette(), unpacktable(), indextable(), bitfields(bitfields)
+{
+	if ((bitdepth != DIBBitDepth::Bit16)&&(bitdepth != DIBBitDepth::Bit32)) { throw InvalidDIBFormatException("ビットフィールド形式は16ビットまたは32ビットでのみ使用できます。"); }
+}
+void DIBRowConverter::Convert(const uint8_t* src, RGB8_t* dest, size_t count) const
+{
+	if (bitfields.has_value()) { ConvertBitFields(src, dest, count); return; }
+	switch(bitdepth)
+	{
+		case DIBBitDepth::Bit1:
+		{
+			if (!unpacktable.empty()) { ConvertUnpacked(src, dest, count); }
+			else { ConvertIndexed1(src, dest, count, palette); }
+			break;
+		}
+		case DIBBitDepth::Bit4:
+		{
+			if (!unpacktable.empty()) { ConvertUnpacked(src, dest, count); }
+			else { ConvertIndexed4(src, dest, count, palette); }
+			break;
+		}
+		case DIBBitDepth::Bit8:
+		{
+			if (!indextable.empty()) { ConvertPacked8(src, dest, count); }
+			else { ConvertIndexed8(src, dest, count, palette); }
+			break;
+		}
+		case DIBBitDepth::Bit16: { ConvertRGB555(src, dest, count); break; }
+		case DIBBitDepth::Bit24: { ConvertBGR24(src, dest, count); break; }
+		case DIBBitDepth::Bit32: { ConvertBGRX32(src, dest, count); break; }
+		default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
+	}
+}
+void DIBRowConverter::Pack(const RGB8_t* src, uint8_t* dest, size_t count) const
+{
+	if (bitfields.has_value()) { PackBitFields(src, dest, count); return; }
+	switch(bitdepth)
+	{
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		case DIBBitDepth::Bit8:
+		{ PackIndexed(src, dest, count); break; }
+		case DIBBitDepth::Bit16: { PackRGB555(src, dest, count); break; }
+		case DIBBitDepth::Bit24:
+		{
+			for (auto i: Range<size_t>(0, count).GetStdIterator())
+			{
+				dest[(i * 3) + 0] = src[i].B().Data().Data();
+				dest[(i * 3) + 1] = src[i].G().Data().Data();
+				dest[(i * 3) + 2] = src[i].R().Data().Data();
+			}
+			break;
+		}
+		case DIBBitDepth::Bit32:
+		{
+			for (auto i: Range<size_t>(0, count).GetStdIterator())
+			{
+				dest[(i * 4) + 0] = src[i].B().Data().Data();
+				dest[(i * 4) + 1] = src[i].G().Data().Data();
+				dest[(i * 4) + 2] = src[i].R().Data().Data();
+				dest[(i * 4) + 3] = 0;
+			}
+			break;
+		}
+		default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
+	}
+}
+void DIBRowConverter::ConvertRGB555(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel)
+{
+	auto& kernels = Kernels(kernel);
+	if (kernels.RGB555 != nullptr) { kernels.RGB555(src, reinterpret_cast<uint8_t*>(dest), count); return; }
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		auto data = DIBPixelData<DIBBitDepth::Bit16>();
+		std::memcpy(&data, src + (i * sizeof(DIBPixelData<DIBBitDepth::Bit16>)), sizeof(DIBPixelData<DIBBitDepth::Bit16>));
+		dest[i] = DIBPixelPerser::ToRGB(data);
+	}
+}
+void DIBRowConverter::ConvertRGB565(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel)
+{
+	auto& kernels = Kernels(kernel);
+	if (kernels.RGB565 != nullptr) { kernels.RGB565(src, reinterpret_cast<uint8_t*>(dest), count); return; }
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		uint32_t v = src[i * 2] | (uint32_t(src[i * 2 + 1]) << 8);
+		dest[i] = RGB8_t(Proportion8_t(Expand5((v >> 11) & 0x1F), 0xFF), Proportion8_t(Expand6((v >> 5) & 0x3F), 0xFF), Proportion8_t(Expand5(v & 0x1F), 0xFF));
+	}
+}
+void DIBRowConverter::ConvertBGR24(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel)
+{
+	auto& kernels = Kernels(kernel);
+	if (kernels.BGR24 != nullptr) { kernels.BGR24(src, reinterpret_cast<uint8_t*>(dest), count); return; }
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		auto data = RGBTriple_t();
+		std::memcpy(&data, src + (i * sizeof(RGBTriple_t)), sizeof(RGBTriple_t));
+		dest[i] = RGB8_t(data);
+	}
+}
+void DIBRowConverter::ConvertBGRX32(const uint8_t* src, RGB8_t* dest, size_t count, KernelSelection kernel)
+{
+	auto& kernels = Kernels(kernel);
+	if (kernels.BGRX32 != nullptr) { kernels.BGRX32(src, reinterpret_cast<uint8_t*>(dest), count); return; }
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		auto data = RGBQuad_t();
+		std::memcpy(&data, src + (i * sizeof(RGBQuad_t)), sizeof(RGBQuad_t));
+		dest[i] = RGB8_t(data);
+	}
+}
+void DIBRowConverter::PackRGB555(const RGB8_t* src, uint8_t* dest, size_t count, KernelSelection kernel)
+{
+	auto& kernels = Kernels(kernel);
+	if (kernels.PackRGB555 != nullptr) { kernels.PackRGB555(reinterpret_cast<const uint8_t*>(src), dest, count); return; }
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		auto data = DIBPixelPerser::ToPixel16(src[i]);
+		std::memcpy(dest + (i * sizeof(DIBPixelData<DIBBitDepth::Bit16>)), &data, sizeof(DIBPixelData<DIBBitDepth::Bit16>));
+	}
+}
+void DIBRowConverter::PackRGB565(const RGB8_t* src, uint8_t* dest, size_t count, KernelSelection kernel)
+{
+	auto& kernels = Kernels(kernel);
+	if (kernels.PackRGB565 != nullptr) { kernels.PackRGB565(reinterpret_cast<const uint8_t*>(src), dest, count); return; }
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		uint32_t v = ((src[i].R().Data().Data() & 0xF8) << 8) | ((src[i].G().Data().Data() & 0xFC) << 3) | (src[i].B().Data().Data() >> 3);
+		dest[i * 2 + 0] = uint8_t(v);
+		dest[i * 2 + 1] = uint8_t(v >> 8);
+	}
+}
+const char* DIBRowConverter::KernelName() { return Kernels().Name; }
+void DIBRowConverter::ConvertIndexed1(const uint8_t* src, RGB8_t* dest, size_t count, const std::vector<RGB8_t>& palette)
+{
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		size_t index = (src[i / 8] >> (7 - (i % 8))) & 0x01;
+		if (palette.size() <= index) { throw InvalidDIBFormatException("色パレットの範囲外のインデックスが含まれています。"); }
+		dest[i] = palette[index];
+	}
+}
+void DIBRowConverter::ConvertIndexed4(const uint8_t* src, RGB8_t* dest, size_t count, const std::vector<RGB8_t>& palette)
+{
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		size_t index = (src[i / 2] >> ((i % 2 == 0)?(4):(0))) & 0x0F;
+		if (palette.size() <= index) { throw InvalidDIBFormatException("色パレットの範囲外のインデックスが含まれています。"); }
+		dest[i] = palette[index];
+	}
+}
+void DIBRowConverter::ConvertIndexed8(const uint8_t* src, RGB8_t* dest, size_t count, const std::vector<RGB8_t>& palette)
+{
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		if (palette.size() <= src[i]) { throw InvalidDIBFormatException("色パレットの範囲外のインデックスが含まれています。"); }
+		dest[i] = palette[src[i]];
+	}
+}
+void DIBRowConverter::ConvertBitFields(const uint8_t* src, RGB8_t* dest, size_t count) const
+{
+	//	よく使用される配置は無圧縮RGB向けの実装で変換する
+	switch(bitdepth)
+	{
+		case DIBBitDepth::Bit16:
+		{
+			switch(bitfields->Layout())
+			{
+				case DIBBitFields::Layouts::RGB555: { ConvertRGB555(src, dest, count); break; }
+				case DIBBitFields::Layouts::RGB565: { ConvertRGB565(src, dest, count); break; }
+				default: { ConvertMasked<uint16_t>(src, dest, count, *bitfields); break; }
+			}
+			break;
+		}
+		case DIBBitDepth::Bit32:
+		{
+			switch(bitfields->Layout())
+			{
+				case DIBBitFields::Layouts::XRGB8888: { ConvertBGRX32(src, dest, count); break; }
+				default: { ConvertMasked<uint32_t>(src, dest, count, *bitfields); break; }
+			}
+			break;
+		}
+		default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
+	}
+}
+void DIBRowConverter::PackBitFields(const RGB8_t* src, uint8_t* dest, size_t count) const
+{
+	//	ピクセルデータはリトルエンディアンで格納する
+	auto length = size_t(uint16_t(bitdepth) / 8);
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		auto data = bitfields->ToPixel(src[i]);
+		for (auto b: Range<size_t>(0, length).GetStdIterator()) { dest[(i * length) + b] = uint8_t(data >> (8 * b)); }
+	}
+}
+void DIBRowConverter::PackIndexed(const RGB8_t* src, uint8_t* dest, size_t count) const
+{
+	if (palette.empty()) { throw InvalidOperationException("色パレットが空のためインデックスに変換できません。"); }
+	auto bits = size_t(uint16_t(bitdepth));
+	//	インデックスとして表現できない色パレットの要素は使用しない
+	auto entries = std::min(palette.size(), size_t(1) << bits);
+	//	1ピクセル未満の端数ビットを含むバイトをまとめて初期化しておく
+	std::fill_n(dest, ((count * bits) + 7) / 8, uint8_t(0));
+	for (auto i: Range<size_t>(0, count).GetStdIterator())
+	{
+		size_t index = 0;
+		uint32_t nearest = UINT32_MAX;
+		for (auto p: Range<size_t>(0, entries).GetStdIterator())
+		{
+			auto dr = int32_t(src[i].R().Data().Data()) - int32_t(palette[p].R().Data().Data());
+			auto dg = int32_t(src[i].G().Data().Data()) - int32_t(palette[p].G().Data().Data());
+			auto db = int32_t(src[i].B().Data().Data()) - int32_t(palette[p].B().Data().Data());
+			auto distance = uint32_t((dr * dr) + (dg * dg) + (db * db));
+			if (distance < nearest) { index = p; nearest = distance; }
+			if (distance == 0) { break; }
+		}
+		//	上位ビットから順に格納する
+		auto bitpos = i * bits;
+		dest[bitpos / 8] |= uint8_t(index << (8 - bits - (bitpos % 8)));
+	}
+}
+void DIBRowConverter::BuildUnpackTable()
+{
+	size_t bits;
+	switch(bitdepth)
+	{
+		case DIBBitDepth::Bit1: { bits = 1; break; }
+		case DIBBitDepth::Bit4: { bits = 4; break; }
+		default: { return; }
+	}
+	//	色パレットがすべてのインデックスを網羅していない場合は参照テーブルを使用しない
+	if (palette.size() < (size_t(1) << bits)) { return; }
+	size_t perbyte = 8 / bits;
+	unpacktable.resize(256 * perbyte);
+	for (auto b: Range<size_t>(0, 256).GetStdIterator())
+	{
+		for (auto i: Range<size_t>(0, perbyte).GetStdIterator())
+		{
+			unpacktable[(b * perbyte) + i] = palette[(b >> (8 - (bits * (i + 1)))) & ((size_t(1) << bits) - 1)];
+		}
+	}
+}
+void DIBRowConverter::BuildIndexTable()
+{
+	if (bitdepth != DIBBitDepth::Bit8) { return; }
+	//	RGB8_t をバイト列として扱えない環境では参照テーブルを使用しない
+	if (Kernels().Indexed8 == nullptr) { return; }
+	//	色パレットの範囲外のインデックスは変換前に検出するため、テーブルの該当部分は使用されない
+	indextable.assign(256, uint32_t());
+	for (auto i: Range<size_t>(0, std::min(palette.size(), size_t(256))).GetStdIterator())
+	{
+		indextable[i] = uint32_t(palette[i].R().Data().Data()) | (uint32_t(palette[i].G().Data().Data()) << 8) | (uint32_t(palette[i].B().Data().Data()) << 16);
+	}
+}
+void DIBRowConverter::ConvertPacked8(const uint8_t* src, RGB8_t* dest, size_t count) const
+{
+	//	インデックスの検査は水平ライン単位で1回のみ行う
+	if ((palette.size() < 256)&&(count != 0)&&(palette.size() <= *std::max_element(src, src + count)))
+	{
+		throw InvalidDIBFormatException("色パレットの範囲外のインデックスが含まれています。");
+	}
+	Kernels().Indexed8(src, reinterpret_cast<uint8_t*>(dest), count, indextable.data());
+}
+void DIBRowConverter::ConvertUnpacked(const uint8_t* src, RGB8_t* dest, size_t count) const
+{
+	size_t perbyte = unpacktable.size() / 256;
+	size_t whole = count / perbyte;
+	for (auto i: Range<size_t>(0, whole).GetStdIterator())
+	{
+		std::copy_n(unpacktable.data() + (src[i] * perbyte), perbyte, dest + (i * perbyte));
+	}
+	//	末尾の端数ピクセル
+	size_t rest = count % perbyte;
+	if (rest != 0) { std::copy_n(unpacktable.data() + (src[whole] * perbyte), rest, dest + (whole * perbyte)); }
+}
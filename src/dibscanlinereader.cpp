@@ -0,0 +1,219 @@
+//	stationaryorbit.graphics-dib:/dibscanlinereader
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "stationaryorbit/graphics-dib/dibscanlinereader.hpp"
+#include "stationaryorbit/graphics-dib/rgbdecoder.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+DIBScanlineFormat DIBScanlineFormat::Load(DIBLoader& loader, size_t maxstridelength)
+{
+	if (!loader.IsEnable()) { throw InvalidOperationException("無効な状態のloaderが渡されました。"); }
+	//	ファイル上で前方にあるものから順に読み込む
+	auto headersize = loader.HeaderSize();
+	auto palette = std::vector<RGB8_t>();
+	if (headersize == int32_t(DIBCoreHeader::Size))
+	{
+		auto ihead = DIBCoreHeader();
+		DIBLoaderHelper::Read(loader, ihead, sizeof(DIBFileHeader) + sizeof(int32_t));
+		if ((ihead.Width == 0)||(ihead.Height == 0)) { throw InvalidDIBFormatException("情報ヘッダの画像の大きさが無効です。"); }
+		auto size = DisplayRectSize(ihead.Width, ihead.Height);
+		auto palsize = ResolvePaletteSize(ihead.BitCount, 0);
+		if (ihead.BitCount == DIBBitDepth::Bit24) { palsize = 0; }
+		else if (palsize == 0) { throw InvalidDIBFormatException("情報ヘッダのBitCountの内容が無効です。"); }
+		ValidateStrideLength(DIBRGBEncoder::GetStrideLength(ihead.BitCount, size), maxstridelength);
+		if (palsize != 0)
+		{
+			auto lpal = std::vector<RGBTriple_t>(palsize);
+			DIBLoaderHelper::Read(loader, lpal.data(), sizeof(DIBFileHeader) + DIBCoreHeader::Size, palsize);
+			palette.reserve(palsize);
+			for (auto i: lpal) { palette.push_back(RGB8_t(i)); }
+		}
+		return DIBScanlineFormat{ ihead.BitCount, size, false, size_t(loader.FileHead().Offset()), DIBRGBEncoder::GetStrideLength(ihead.BitCount, size), DIBRowConverter(ihead.BitCount, palette) };
+	}
+	if (headersize < int32_t(DIBInfoHeader::Size)) { throw InvalidDIBFormatException("情報ヘッダの長さはInfoHeaderでサポートされる最小の長さよりも短いです。"); }
+	//	V4・V5 ヘッダも先頭は InfoHeader と同じ並びであり、色マスクは InfoHeader の直後に配置される
+	auto ihead = DIBInfoHeader();
+	DIBLoaderHelper::Read(loader, ihead, sizeof(DIBFileHeader) + sizeof(int32_t));
+	//	横幅・縦幅が0の画像は水平ラインを持たないか、データを消費せずに水平ラインが得られてしまうため扱わない
+	if ((ihead.Width <= 0)||(ihead.Height == 0)||(ihead.Height == std::numeric_limits<int32_t>::min())) { throw InvalidDIBFormatException("情報ヘッダの画像の大きさが無効です。"); }
+	ValidateBitCount(ihead.Compression, ihead.BitCount);
+	auto topdown = ihead.Height < 0;
+	auto size = DisplayRectSize(ihead.Width, (topdown)?(-ihead.Height):(ihead.Height));
+	ValidateStrideLength(DIBRGBEncoder::GetStrideLength(ihead.BitCount, size), maxstridelength);
+	auto result = [&](DIBRowConverter&& converter) { return DIBScanlineFormat{ ihead.BitCount, size, topdown, size_t(loader.FileHead().Offset()), DIBRGBEncoder::GetStrideLength(ihead.BitCount, size), std::move(converter) }; };
+	switch(ihead.Compression)
+	{
+		case DIBCompressionMethod::RGB:
+		{
+			if (uint16_t(ihead.BitCount) <= uint16_t(DIBBitDepth::Bit8))
+			{
+				auto palsize = ResolvePaletteSize(ihead.BitCount, ihead.ClrUsed);
+				auto lpal = std::vector<RGBQuad_t>(palsize);
+				DIBLoaderHelper::Read(loader, lpal.data(), sizeof(DIBFileHeader) + headersize, palsize);
+				palette.reserve(palsize);
+				for (auto i: lpal) { palette.push_back(RGB8_t(i)); }
+			}
+			return result(DIBRowConverter(ihead.BitCount, palette));
+		}
+		case DIBCompressionMethod::BITFIELDS:
+		{
+			//	BITFIELDS の場合はα成分のマスクを使用しない
+			auto colormask = DIBRGBColorMask();
+			DIBLoaderHelper::Read(loader, colormask, sizeof(DIBFileHeader) + DIBInfoHeader::Size);
+			return result(DIBRowConverter(ihead.BitCount, DIBBitFields(colormask)));
+		}
+		case DIBCompressionMethod::ALPHABITFIELDS:
+		{
+			auto colormask = DIBRGBAColorMask();
+			DIBLoaderHelper::Read(loader, colormask, sizeof(DIBFileHeader) + DIBInfoHeader::Size);
+			return result(DIBRowConverter(ihead.BitCount, DIBBitFields(colormask)));
+		}
+		case DIBCompressionMethod::RLE4:
+		case DIBCompressionMethod::RLE8:
+		case DIBCompressionMethod::JPEG:
+		case DIBCompressionMethod::PNG:
+		{ throw NotImplementedException(); }
+		default: { throw InvalidDIBFormatException("情報ヘッダのComplessionMethodの内容が無効です。"); }
+	}
+}
+size_t DIBScanlineFormat::HeadLength(const char* data, size_t length)
+{
+	constexpr size_t headlength = sizeof(DIBFileHeader) + sizeof(int32_t);
+	if (length < headlength) { return headlength; }
+	auto fhead = DIBFileHeader();
+	std::memcpy(&fhead, data, sizeof(DIBFileHeader));
+	if (!fhead.CheckFileHeader()) { throw InvalidDIBFormatException("ファイルヘッダの内容が無効です。"); }
+	auto headersize = int32_t();
+	std::memcpy(&headersize, data + sizeof(DIBFileHeader), sizeof(int32_t));
+	//	データを揃える前に長さを確定させるため、既知の最大の長さを超える情報ヘッダは扱わない
+	if ((headersize < int32_t(DIBCoreHeader::Size))||(int32_t(DIBV5Header::Size) < headersize)) { throw InvalidDIBFormatException("情報ヘッダの長さが無効です。"); }
+	if (headersize == int32_t(DIBCoreHeader::Size))
+	{
+		if (length < (headlength + sizeof(DIBCoreHeader))) { return headlength + sizeof(DIBCoreHeader); }
+		auto ihead = DIBCoreHeader();
+		std::memcpy(&ihead, data + headlength, sizeof(DIBCoreHeader));
+		auto palsize = (ihead.BitCount == DIBBitDepth::Bit24)?(size_t(0)):(ResolvePaletteSize(ihead.BitCount, 0));
+		if ((ihead.BitCount != DIBBitDepth::Bit24)&&(palsize == 0)) { throw InvalidDIBFormatException("情報ヘッダのBitCountの内容が無効です。"); }
+		return sizeof(DIBFileHeader) + DIBCoreHeader::Size + (sizeof(RGBTriple_t) * palsize);
+	}
+	//	InfoHeader より短いヘッダは Load で無効な形式として扱われる
+	if (headersize < int32_t(DIBInfoHeader::Size)) { return headlength; }
+	if (length < (headlength + sizeof(DIBInfoHeader))) { return headlength + sizeof(DIBInfoHeader); }
+	auto ihead = DIBInfoHeader();
+	std::memcpy(&ihead, data + headlength, sizeof(DIBInfoHeader));
+	ValidateBitCount(ihead.Compression, ihead.BitCount);
+	auto result = sizeof(DIBFileHeader) + size_t(headersize);
+	switch(ihead.Compression)
+	{
+		case DIBCompressionMethod::RGB:
+		{
+			if (uint16_t(ihead.BitCount) <= uint16_t(DIBBitDepth::Bit8)) { result += sizeof(RGBQuad_t) * ResolvePaletteSize(ihead.BitCount, ihead.ClrUsed); }
+			return result;
+		}
+		case DIBCompressionMethod::BITFIELDS: { return std::max(result, sizeof(DIBFileHeader) + DIBInfoHeader::Size + sizeof(DIBRGBColorMask)); }
+		case DIBCompressionMethod::ALPHABITFIELDS: { return std::max(result, sizeof(DIBFileHeader) + DIBInfoHeader::Size + sizeof(DIBRGBAColorMask)); }
+		default: { return result; }
+	}
+}
+size_t DIBScanlineFormat::ResolvePaletteSize(DIBBitDepth bitdepth, uint32_t clrused)
+{
+	switch(bitdepth)
+	{
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		case DIBBitDepth::Bit8:
+		{
+			size_t maxsize = size_t(1) << uint16_t(bitdepth);
+			if (clrused == 0) { return maxsize; }
+			if (maxsize < clrused) { throw InvalidDIBFormatException("情報ヘッダのClrUsedの値がBitCountでサポートされている値を超えています。"); }
+			return clrused;
+		}
+		default: { return 0; }
+	}
+}
+void DIBScanlineFormat::ValidateBitCount(DIBCompressionMethod compression, DIBBitDepth bitdepth)
+{
+	switch(compression)
+	{
+		case DIBCompressionMethod::RGB:
+		{
+			switch(bitdepth)
+			{
+				case DIBBitDepth::Bit1:
+				case DIBBitDepth::Bit4:
+				case DIBBitDepth::Bit8:
+				case DIBBitDepth::Bit16:
+				case DIBBitDepth::Bit24:
+				case DIBBitDepth::Bit32:
+				{ return; }
+				default: { throw InvalidDIBFormatException("情報ヘッダのBitCountの内容が無効です。"); }
+			}
+		}
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::ALPHABITFIELDS:
+		{
+			if ((bitdepth != DIBBitDepth::Bit16)&&(bitdepth != DIBBitDepth::Bit32)) { throw InvalidDIBFormatException("情報ヘッダのBitCountの内容が無効です。"); }
+			return;
+		}
+		//	その他の圧縮形式の判定は Load で行う
+		default: { return; }
+	}
+}
+void DIBScanlineFormat::ValidateStrideLength(size_t stridelength, size_t maxstridelength)
+{
+	if (maxstridelength < stridelength) { throw InvalidDIBFormatException("1水平ラインの長さが上限を超えています。"); }
+}
+
+DIBScanlineReader::DIBScanlineReader(DIBLoader& loader, int32_t rowcount, size_t maxstridelength)
+	: loader(loader), format(DIBScanlineFormat::Load(loader, maxstridelength)), rowcount(rowcount), buffer(), bufferfirst(0), buffercount(0), current(-1), row()
+{
+	if (rowcount <= 0) { throw std::invalid_argument("rowcountに0以下の値を指定することはできません。"); }
+	buffer.resize(format.StrideLength * std::min(rowcount, std::max(format.Size.Height(), 1)));
+	row.resize(format.Size.Width());
+}
+bool DIBScanlineReader::Next()
+{
+	if (format.Size.Height() <= current) { return false; }
+	++current;
+	if (format.Size.Height() <= current) { return false; }
+	if ((bufferfirst + buffercount) <= current) { Fill(); }
+	format.Converter.Convert(buffer.data() + (format.StrideLength * (current - bufferfirst)), row.data(), format.Size.Width());
+	return true;
+}
+int32_t DIBScanlineReader::RowsRead() const { return std::clamp(current + 1, 0, format.Size.Height()); }
+int32_t DIBScanlineReader::CurrentY() const
+{
+	if (!HasValue()) { throw InvalidOperationException("現在の位置は値を持っていません。"); }
+	return format.ResolveY(current);
+}
+const Graphics::RGB8_t* DIBScanlineReader::Current() const
+{
+	if (!HasValue()) { throw InvalidOperationException("現在の位置は値を持っていません。"); }
+	return row.data();
+}
+void DIBScanlineReader::Fill()
+{
+	bufferfirst += buffercount;
+	buffercount = std::min(rowcount, format.Size.Height() - bufferfirst);
+	loader.Read((char*)buffer.data(), format.Offset + (format.StrideLength * bufferfirst), format.StrideLength * buffercount);
+}
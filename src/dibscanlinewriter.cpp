@@ -0,0 +1,136 @@
+//	stationaryorbit.graphics-dib:/dibscanlinewriter
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include <stdexcept>
+#include "stationaryorbit/graphics-dib/dibscanlinewriter.hpp"
+#include "stationaryorbit/graphics-dib/rgbdecoder.hpp"
+#include "stationaryorbit/graphics-dib/dibbandencoder.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+DIBScanlineWriter::DIBScanlineWriter(DIBLoader& loader, const DIBInfoHeader& header, DIBScanlineOrder order)
+	: loader(loader), fhead(), ihead(header), size(header.Width, header.Height), order(order), stridelength(), packer(), rowbuffer(), written(0), closed(false)
+{
+	if ((header.Width < 0)||(header.Height < 0)) { throw std::invalid_argument("画像の大きさに負の値を指定することはできません。"); }
+	switch(header.Compression)
+	{
+		case DIBCompressionMethod::RGB:
+		{
+			switch(header.BitCount)
+			{
+				case DIBBitDepth::Bit1:
+				case DIBBitDepth::Bit4:
+				case DIBBitDepth::Bit8:
+				{ throw NotImplementedException(); }
+				case DIBBitDepth::Bit16:
+				case DIBBitDepth::Bit24:
+				case DIBBitDepth::Bit32:
+				{ break; }
+				default: { throw std::invalid_argument("BitCountの内容が無効です。"); }
+			}
+			break;
+		}
+		case DIBCompressionMethod::RLE8:
+		case DIBCompressionMethod::RLE4:
+		case DIBCompressionMethod::BITFIELDS:
+		case DIBCompressionMethod::JPEG:
+		case DIBCompressionMethod::PNG:
+		case DIBCompressionMethod::ALPHABITFIELDS:
+		{ throw NotImplementedException(); }
+		default: { throw std::invalid_argument("CompressionMethodの内容が無効です。"); }
+	}
+	stridelength = DIBRGBEncoder::GetStrideLength(header.BitCount, size);
+	packer = DIBRowConverter(header.BitCount);
+	rowbuffer.resize(stridelength);
+	std::get<DIBInfoHeader>(ihead).SizeImage = uint32_t(stridelength * size.Height());
+	fhead.Offset(int32_t(sizeof(DIBFileHeader) + DIBInfoHeader::Size));
+	WriteHead();
+}
+DIBScanlineWriter::DIBScanlineWriter(DIBLoader& loader, const DIBCoreHeader& header, DIBScanlineOrder order)
+	: loader(loader), fhead(), ihead(header), size(header.Width, header.Height), order(order), stridelength(), packer(), rowbuffer(), written(0), closed(false)
+{
+	switch(header.BitCount)
+	{
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		case DIBBitDepth::Bit8:
+		{ throw NotImplementedException(); }
+		case DIBBitDepth::Bit24: { break; }
+		default: { throw std::invalid_argument("BitCountの内容が無効です。"); }
+	}
+	stridelength = DIBRGBEncoder::GetStrideLength(header.BitCount, size);
+	packer = DIBRowConverter(header.BitCount);
+	rowbuffer.resize(stridelength);
+	fhead.Offset(int32_t(sizeof(DIBFileHeader) + DIBCoreHeader::Size));
+	WriteHead();
+}
+DIBScanlineWriter::~DIBScanlineWriter()
+{
+	try { Close(); }
+	catch (...) {}
+}
+int32_t DIBScanlineWriter::NextY() const
+{
+	if (IsCompleted()) { throw InvalidOperationException("すべての水平ラインが書き込み済みです。"); }
+	return (order == DIBScanlineOrder::File)?(size.Height() - 1 - written):(written);
+}
+void DIBScanlineWriter::WriteRow(const RGB8_t* row)
+{
+	if (closed) { throw InvalidOperationException("このオブジェクトはすでにCloseされています。"); }
+	auto y = NextY();
+	packer.Pack(row, rowbuffer.data(), size.Width());
+	//	ファイル上では画像の下端の水平ラインが先頭になる
+	loader.Write((const char*)rowbuffer.data(), fhead.Offset() + (stridelength * (size.Height() - 1 - y)), stridelength);
+	++written;
+}
+void DIBScanlineWriter::WriteRow(const std::vector<RGB8_t>& row)
+{
+	if (row.size() != size_t(size.Width())) { throw std::invalid_argument("rowの長さが画像の横幅と一致しません。"); }
+	WriteRow(row.data());
+}
+void DIBScanlineWriter::WriteImage(const Image<RGB8_t>& image, size_t threads)
+{
+	if (closed) { throw InvalidOperationException("このオブジェクトはすでにCloseされています。"); }
+	if (written != 0) { throw InvalidOperationException("すでに水平ラインが書き込まれています。"); }
+	if ((image.Size().Width() != size.Width())||(image.Size().Height() != size.Height())) { throw std::invalid_argument("imageの大きさが画像の大きさと一致しません。"); }
+	DIBBandEncodeHelper::Encode(loader, fhead.Offset(), size, packer, image, threads);
+	written = size.Height();
+}
+void DIBScanlineWriter::Close()
+{
+	if (closed) { return; }
+	if (!IsCompleted()) { throw InvalidOperationException("書き込まれていない水平ラインがあります。"); }
+	loader.Sync();
+	closed = true;
+}
+void DIBScanlineWriter::WriteHead()
+{
+	//	ヘッダは書き込み後に更新しないため、ファイルの長さもここで確定する
+	fhead.FileSize(int32_t(fhead.Offset() + (stridelength * size.Height())));
+	std::copy(&(fhead.FileType_Signature[0]), &(fhead.FileType_Signature[2]), &(fhead.FileType[0]));
+	std::visit([&](const auto& header)
+	{
+		loader.WriteV(
+		{
+			DIBLoaderHelper::Segment(fhead, 0),
+			DIBLoaderHelper::Segment(std::decay_t<decltype(header)>::Size, sizeof(DIBFileHeader)),
+			DIBLoaderHelper::Segment(header, sizeof(DIBFileHeader) + sizeof(uint32_t))
+		});
+	}, ihead);
+}
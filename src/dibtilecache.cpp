@@ -0,0 +1,111 @@
+//	stationaryorbit.graphics-dib:/dibtilecache
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include <stdexcept>
+#include "stationaryorbit/graphics-dib/dibtilecache.hpp"
+using namespace zawa_ch::StationaryOrbit;
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+DIBTileCache::DIBTileCache() : imagesize(0, 0), tilesize(DefaultTileSize), capacity(0), usage(0), tiles(), tileindex(), statistics() {}
+DIBTileCache::DIBTileCache(const DisplayRectSize& imagesize, size_t capacity, int32_t tilesize)
+	: imagesize(imagesize), tilesize(tilesize), capacity(capacity), usage(0), tiles(), tileindex(), statistics()
+{
+	if (tilesize <= 0) { throw std::invalid_argument("tilesizeに0以下の値を指定することはできません。"); }
+}
+Graphics::RGB8_t DIBTileCache::Get(const DisplayPoint& pos, const DecodeFunction& decode)
+{
+	if ( (pos.X() < 0)||(pos.Y() < 0)||(imagesize.Width() <= pos.X())||(imagesize.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
+	const auto& tile = Fetch(pos.X() / tilesize, pos.Y() / tilesize, decode);
+	return tile.data[(size_t(pos.Y() - tile.area.Top()) * tile.area.Width()) + (pos.X() - tile.area.Left())];
+}
+void DIBTileCache::CopyTo(WritableImage<RGB8_t>& dest, const DisplayRectangle& area, const DisplayPoint& destorigin, const DecodeFunction& decode)
+{
+	if ((area.Left() < 0)||(area.Top() < 0)||(imagesize.Width() < area.Right())||(imagesize.Height() < area.Bottom())) { throw std::out_of_range("areaで指定された領域が画像領域を超えています。"); }
+	if ((area.Width() <= 0)||(area.Height() <= 0)) { return; }
+	for (auto ty: Range<int32_t>(area.Top() / tilesize, ((area.Bottom() - 1) / tilesize) + 1).GetStdIterator())
+	{
+		for (auto tx: Range<int32_t>(area.Left() / tilesize, ((area.Right() - 1) / tilesize) + 1).GetStdIterator())
+		{
+			//	タイルへの参照は次の取得で破棄される可能性があるため、次のタイルを取得する前にコピーを済ませる
+			const auto& tile = Fetch(tx, ty, decode);
+			auto x0 = std::max(area.Left(), tile.area.Left());
+			auto x1 = std::min(area.Right(), tile.area.Right());
+			auto y0 = std::max(area.Top(), tile.area.Top());
+			auto y1 = std::min(area.Bottom(), tile.area.Bottom());
+			for (auto y: Range<int32_t>(y0, y1).GetStdIterator())
+			{
+				auto row = tile.data.data() + (size_t(y - tile.area.Top()) * tile.area.Width());
+				for (auto x: Range<int32_t>(x0, x1).GetStdIterator()) { dest.At(DisplayPoint(x, y) - area.Origin() + destorigin) = row[x - tile.area.Left()]; }
+			}
+		}
+	}
+}
+void DIBTileCache::Invalidate(const DisplayRectangle& area) noexcept
+{
+	for (auto i = tiles.begin(); i != tiles.end(); )
+	{
+		auto overlaps = (i->area.Left() < area.Right())&&(area.Left() < i->area.Right())&&(i->area.Top() < area.Bottom())&&(area.Top() < i->area.Bottom());
+		if (overlaps)
+		{
+			usage -= i->data.size() * sizeof(RGB8_t);
+			tileindex.erase(i->key);
+			i = tiles.erase(i);
+		}
+		else { ++i; }
+	}
+}
+void DIBTileCache::Clear() noexcept
+{
+	tileindex.clear();
+	tiles.clear();
+	usage = 0;
+}
+void DIBTileCache::ResetStatistics() noexcept { statistics = DIBTileCacheStatistics(); }
+const DIBTileCache::Tile& DIBTileCache::Fetch(int32_t tx, int32_t ty, const DecodeFunction& decode)
+{
+	auto key = ResolveKey(tx, ty);
+	auto found = tileindex.find(key);
+	if (found != tileindex.end())
+	{
+		++statistics.Hit;
+		//	最近使用したタイルを先頭に移動
+		tiles.splice(tiles.begin(), tiles, found->second);
+		return *found->second;
+	}
+	++statistics.Miss;
+	auto left = tx * tilesize;
+	auto top = ty * tilesize;
+	auto area = DisplayRectangle(left, top, std::min(tilesize, imagesize.Width() - left), std::min(tilesize, imagesize.Height() - top));
+	auto tile = Tile{ key, area, std::vector<RGB8_t>(size_t(area.Width()) * area.Height()) };
+	decode(area, tile.data.data());
+	auto length = tile.data.size() * sizeof(RGB8_t);
+	//	容量に収まるまで最も長く使用されていないタイルを破棄
+	//	容量を超える大きさのタイルは、次の取得まで保持する
+	while ((!tiles.empty())&&(capacity < (usage + length)))
+	{
+		usage -= tiles.back().data.size() * sizeof(RGB8_t);
+		tileindex.erase(tiles.back().key);
+		tiles.pop_back();
+		++statistics.Eviction;
+	}
+	tiles.push_front(std::move(tile));
+	tileindex.emplace(key, tiles.begin());
+	usage += length;
+	return tiles.front();
+}
@@ -0,0 +1,33 @@
+//	stationaryorbit.graphics-dib:/dibtypeddecoder
+//	Copyright 2021 zawa-ch.
+//	GPLv3 (or later) license
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//	See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.
+//	If not, see <http://www.gnu.org/licenses/>.
+//
+#include "stationaryorbit/graphics-dib/dibtypeddecoder.hpp"
+using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
+
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedDecoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit1>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedDecoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit4>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedDecoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit8>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedDecoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit16>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedDecoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit24>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedDecoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit32>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedEncoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit1>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedEncoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit4>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedEncoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit8>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedEncoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit16>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedEncoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit24>;
+template class zawa_ch::StationaryOrbit::Graphics::DIB::DIBTypedEncoder<zawa_ch::StationaryOrbit::Graphics::DIB::DIBBitDepth::Bit32>;
@@ -21,7 +21,7 @@ using namespace zawa_ch::StationaryOrbit;
 using namespace zawa_ch::StationaryOrbit::Graphics::DIB;
 
 DIBRGBDecoder::DIBRGBDecoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size)
-	: loader(loader), offset(offset), bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), pixellength(DIBRGBEncoder::GetPxLength(bitdepth)), stridelength(DIBRGBEncoder::GetStrideLength(bitdepth, size))
+	: loader(loader), offset(offset), bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), pixellength(DIBRGBEncoder::GetPxLength(bitdepth)), stridelength(DIBRGBEncoder::GetStrideLength(bitdepth, size)), rowlength(DIBRGBEncoder::GetRowLength(bitdepth, size))
 {
 	Reset();
 }
@@ -30,7 +30,7 @@ bool DIBRGBDecoder::Next()
 	if (IsAfterEnd()) { return false; }
 	++current;
 	if (IsAfterEnd()) { current = length; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 bool DIBRGBDecoder::Next(const IteratorTraits::IteratorDiff_t& count)
@@ -38,7 +38,7 @@ bool DIBRGBDecoder::Next(const IteratorTraits::IteratorDiff_t& count)
 	if (IsAfterEnd()) { return false; }
 	current += count;
 	if (IsAfterEnd()) { current = length; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 bool DIBRGBDecoder::Previous()
@@ -46,7 +46,7 @@ bool DIBRGBDecoder::Previous()
 	if (IsBeforeBegin()) { return false; }
 	--current;
 	if (IsBeforeBegin()) { current = -1; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 bool DIBRGBDecoder::Previous(const IteratorTraits::IteratorDiff_t& count)
@@ -54,14 +54,15 @@ bool DIBRGBDecoder::Previous(const IteratorTraits::IteratorDiff_t& count)
 	if (IsBeforeBegin()) { return false; }
 	current -= count;
 	if (IsBeforeBegin()) { current = -1; return false; }
-	current_value = Get(current);
+	current_value.reset();
 	return true;
 }
 void DIBRGBDecoder::JumpTo(const DisplayPoint& pos)
 {
 	if ( (pos.X() < 0)||(pos.Y() < 0) ) { throw std::invalid_argument("posに指定されている座標が無効です。"); }
+	if ( (size.Width() <= pos.X())||(size.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
 	current = ResolveIndex(pos);
-	current_value = Get(ResolveIndex(pos));
+	current_value.reset();
 }
 void DIBRGBDecoder::Reset() { Reset(IteratorOrigin::Begin); }
 void DIBRGBDecoder::Reset(const IteratorOrigin& origin)
@@ -72,22 +73,35 @@ void DIBRGBDecoder::Reset(const IteratorOrigin& origin)
 		case IteratorOrigin::Begin: { current = 0; break; }
 		case IteratorOrigin::End: { current = length - 1; break; }
 	}
-	current_value = Get(current);
+	current_value.reset();
 }
 bool DIBRGBDecoder::HasValue() const { return (0 <= current)&&(current < length); }
 bool DIBRGBDecoder::IsBeforeBegin() const { return current < 0; }
 bool DIBRGBDecoder::IsAfterEnd() const { return length <= current; }
 Graphics::DisplayPoint DIBRGBDecoder::CurrentPos() const { return ResolvePos(current); }
-DIBRGBDecoder::ValueType DIBRGBDecoder::Current() const { if (HasValue()) { return current_value; } else { throw InvalidOperationException("このイテレータは領域の範囲外を指しています。"); } }
+DIBRGBDecoder::ValueType DIBRGBDecoder::Current() const
+{
+	if (!HasValue()) { throw InvalidOperationException("このイテレータは領域の範囲外を指しています。"); }
+	if (!current_value.has_value()) { current_value = Get(current); }
+	return *current_value;
+}
 void DIBRGBDecoder::Write(const ValueType& value)
 {
+	if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
 	size_t tgt = offset + ResolveOffset(current);
 	switch(bitdepth)
 	{
-		case DIBBitDepth::Bit1: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit1>>(value), tgt); break; }
-		case DIBBitDepth::Bit4: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit4>>(value), tgt); break; }
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		{
+			//	同じバイトに含まれる他のピクセルを保持して書き込む
+			auto data = uint8_t();
+			DIBLoaderHelper::Read(loader, data, tgt);
+			DIBLoaderHelper::Write(loader, InsertPacked(data, std::visit([](auto i)->uint32_t { return uint32_t(i); }, value), current), tgt);
+			break;
+		}
 		case DIBBitDepth::Bit8: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit8>>(value), tgt); break; }
-		case DIBBitDepth::Bit16: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit24>>(value), tgt); break; }
+		case DIBBitDepth::Bit16: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit16>>(value), tgt); break; }
 		case DIBBitDepth::Bit24: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit24>>(value), tgt); break; }
 		case DIBBitDepth::Bit32: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit32>>(value), tgt); break; }
 		default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
@@ -102,22 +116,105 @@ int DIBRGBDecoder::Compare(const DIBRGBDecoder& other) const
 	else if (other.current < current) { return 1; }
 	else { return -1; }
 }
-DIBRGBDecoder::ValueType DIBRGBDecoder::Get(size_t index)
+void DIBRGBDecoder::ReadRow(int32_t y, uint8_t* dest)
+{
+	if ( (y < 0)||(size.Height() <= y) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
+	//	ストライド末尾のパディングは読み込まない
+	DIBLoaderHelper::Read(loader, (char*)dest, offset + (stridelength * (size.Height() - 1 - y)), rowlength);
+}
+void DIBRGBDecoder::ReadRows(int32_t y0, int32_t y1, uint8_t* dest)
+{
+	if ( (y0 < 0)||(y1 < y0)||(size.Height() < y1) ) { throw std::out_of_range("指定された範囲はこの画像領域を超えています。"); }
+	ReadRowsUnchecked(y0, y1, dest);
+}
+void DIBRGBDecoder::DecodeRow(int32_t y, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if ( (y < 0)||(size.Height() <= y) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
+	converter.Convert(FetchBytes(offset + (stridelength * (size.Height() - 1 - y)), rowlength), dest, size.Width());
+}
+void DIBRGBDecoder::DecodeRows(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if ( (y0 < 0)||(y1 < y0)||(size.Height() < y1) ) { throw std::out_of_range("指定された範囲はこの画像領域を超えています。"); }
+	DecodeRowsUnchecked(y0, y1, dest, converter);
+}
+void DIBRGBDecoder::DecodeRegion(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	ValidateRegion(area);
+	DecodeRegionUnchecked(area, dest, converter);
+}
+void DIBRGBDecoder::ValidateRegion(const DisplayRectangle& area) const
+{
+	if ( (area.Left() < 0)||(area.Top() < 0)||(area.Right() < area.Left())||(area.Bottom() < area.Top()) ) { throw std::out_of_range("指定された領域はこの画像領域を超えています。"); }
+	if ( (size.Width() < area.Right())||(size.Height() < area.Bottom()) ) { throw std::out_of_range("指定された領域はこの画像領域を超えています。"); }
+}
+void DIBRGBDecoder::ReadRowsUnchecked(int32_t y0, int32_t y1, uint8_t* dest)
+{
+	if (y0 == y1) { return; }
+	DIBLoaderHelper::Read(loader, (char*)dest, offset + (stridelength * (size.Height() - y1)), (stridelength * (y1 - y0 - 1)) + rowlength);
+}
+void DIBRGBDecoder::DecodeRowsUnchecked(int32_t y0, int32_t y1, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if (y0 == y1) { return; }
+	auto source = FetchBytes(offset + (stridelength * (size.Height() - y1)), (stridelength * (y1 - y0 - 1)) + rowlength);
+	//	ファイル上の並びは画像の下から上であるため、逆順に変換する
+	for (auto i: Range<int32_t>(0, y1 - y0).GetStdIterator())
+	{
+		converter.Convert(source + (stridelength * i), dest + (size_t(size.Width()) * (y1 - y0 - 1 - i)), size.Width());
+	}
+}
+void DIBRGBDecoder::DecodeRegionUnchecked(const DisplayRectangle& area, RGB8_t* dest, const DIBRowConverter& converter)
+{
+	if ( (area.Width() <= 0)||(area.Height() <= 0) ) { return; }
+	auto bits = size_t(uint16_t(bitdepth));
+	if (bits == 0) { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
+	auto x0 = size_t(area.Left());
+	auto x1 = size_t(area.Right());
+	//	領域の左端のピクセルを含むバイトから、右端のピクセルを含むバイトまでを読み込む
+	auto first = (bits * x0) / 8;
+	auto length = (((bits * x1) + 7) / 8) - first;
+	//	1バイトに複数のピクセルを格納する場合、バイトの先頭のピクセルから変換して左端の余分なピクセルを読み飛ばす
+	auto origin = (first * 8) / bits;
+	auto skip = x0 - origin;
+	auto count = x1 - origin;
+	auto colors = std::vector<RGB8_t>((skip != 0)?(count):(0));
+	for (auto y: Range<int32_t>(area.Top(), area.Bottom()).GetStdIterator())
+	{
+		auto source = FetchBytes(offset + (stridelength * (size.Height() - 1 - y)) + first, length);
+		auto row = dest + (size_t(area.Width()) * (y - area.Top()));
+		if (skip == 0) { converter.Convert(source, row, count); }
+		else
+		{
+			converter.Convert(source, colors.data(), count);
+			std::copy(colors.begin() + skip, colors.end(), row);
+		}
+	}
+}
+const uint8_t* DIBRGBDecoder::FetchBytes(size_t pos, size_t length)
+{
+	//	ローダーがデータを直接参照できる場合は複製せずに変換する
+	auto peeked = loader.Peek(pos, length);
+	if (peeked != nullptr) { return (const uint8_t*)peeked; }
+	rowbuffer.resize(length);
+	DIBLoaderHelper::Read(loader, (char*)rowbuffer.data(), pos, length);
+	return rowbuffer.data();
+}
+DIBRGBDecoder::ValueType DIBRGBDecoder::GetUnchecked(const DisplayPoint& pos) const { return Get(ResolveIndex(pos)); }
+DIBRGBDecoder::ValueType DIBRGBDecoder::Get(size_t index) const
 {
 	size_t tgt = offset + ResolveOffset(index);
 	switch(bitdepth)
 	{
 		case DIBBitDepth::Bit1:
 		{
-			auto result = DIBPixelData<DIBBitDepth::Bit1>();
-			DIBLoaderHelper::Read(loader, result, tgt);
-			return ValueType(result);
+			auto data = uint8_t();
+			DIBLoaderHelper::Read(loader, data, tgt);
+			return ValueType(DIBPixelData<DIBBitDepth::Bit1>(ExtractPacked(data, index)));
 		}
 		case DIBBitDepth::Bit4:
 		{
-			auto result = DIBPixelData<DIBBitDepth::Bit4>();
-			DIBLoaderHelper::Read(loader, result, tgt);
-			return ValueType(result);
+			auto data = uint8_t();
+			DIBLoaderHelper::Read(loader, data, tgt);
+			return ValueType(DIBPixelData<DIBBitDepth::Bit4>(ExtractPacked(data, index)));
 		}
 		case DIBBitDepth::Bit8:
 		{
@@ -152,38 +249,85 @@ size_t DIBRGBDecoder::ResolveOffset(const DisplayPoint& pos) const
 {
 	if ( (pos.X() < 0)||(pos.Y() < 0) ) { throw std::invalid_argument("posに指定されている座標が無効です。"); }
 	if ( (size.Width() <= pos.X())||(size.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
-	return (stridelength * (size.Height() - 1 - pos.Y())) + (pixellength * pos.X());
+	return (stridelength * (size.Height() - 1 - pos.Y())) + ((uint16_t(bitdepth) * size_t(pos.X())) / 8);
 }
 size_t DIBRGBDecoder::ResolveOffset(size_t index) const
 {
-	if (length <= index) { throw std::out_of_range("指定されたインデックスはこの画像領域を超えています。"); }
-	return (stridelength * (index / size.Width())) + (pixellength * (index % size.Width()));
+	//	範囲の検査は呼び出し元で行われているため、ここでは行わない
+	return (stridelength * (index / size.Width())) + ((uint16_t(bitdepth) * (index % size.Width())) / 8);
+}
+uint32_t DIBRGBDecoder::ExtractPacked(uint8_t data, size_t index) const
+{
+	auto bits = uint16_t(bitdepth);
+	//	各バイトの上位ビットが左側のピクセルを表す
+	auto shift = 8 - bits - ((bits * (index % size.Width())) % 8);
+	return (data >> shift) & ((1U << bits) - 1);
+}
+uint8_t DIBRGBDecoder::InsertPacked(uint8_t data, uint32_t value, size_t index) const
+{
+	auto bits = uint16_t(bitdepth);
+	auto shift = 8 - bits - ((bits * (index % size.Width())) % 8);
+	auto mask = uint8_t(((1U << bits) - 1) << shift);
+	return uint8_t((data & ~mask) | ((value << shift) & mask));
 }
 
-DIBRGBEncoder::DIBRGBEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size)
-	: loader(loader), offset(offset), bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), current(0), pixellength(GetPxLength(bitdepth)), stridelength(GetStrideLength(bitdepth, size))
+DIBRGBEncoder::DIBRGBEncoder(DIBLoader& loader, size_t offset, DIBBitDepth bitdepth, const DisplayRectSize& size, size_t batchrows)
+	: bitdepth(bitdepth), size(size), length(size.Width() * size.Height()), current(0), pixellength(DIBRGBEncoder::GetPxLength(bitdepth)), stridelength(DIBRGBEncoder::GetStrideLength(bitdepth, size)), batch(loader, offset, size, DIBRGBEncoder::GetStrideLength(bitdepth, size), batchrows)
 {}
+DIBRGBEncoder::~DIBRGBEncoder()
+{
+	try { Flush(); }
+	catch (...) {}
+}
 void DIBRGBEncoder::Write(const ValueType& value)
 {
-	size_t tgt = offset + ResolveOffset(ResolvePos(current));
+	if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
+	auto x = size_t(current % size.Width());
+	auto dest = batch.Row(current);
+	auto data = std::visit([](auto i)->uint32_t { return uint32_t(i); }, value);
 	switch(bitdepth)
 	{
-		case DIBBitDepth::Bit1: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit1>>(value), tgt); break; }
-		case DIBBitDepth::Bit4: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit4>>(value), tgt); break; }
-		case DIBBitDepth::Bit8: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit8>>(value), tgt); break; }
-		case DIBBitDepth::Bit16: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit16>>(value), tgt); break; }
-		case DIBBitDepth::Bit24: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit24>>(value), tgt); break; }
-		case DIBBitDepth::Bit32: { DIBLoaderHelper::Write(loader, std::get<DIBPixelData<DIBBitDepth::Bit32>>(value), tgt); break; }
+		case DIBBitDepth::Bit1:
+		case DIBBitDepth::Bit4:
+		{
+			//	同じバイトに含まれる他のピクセルを保持して格納する
+			auto bits = uint16_t(bitdepth);
+			auto shift = 8 - bits - ((bits * x) % 8);
+			auto mask = uint8_t(((1U << bits) - 1) << shift);
+			auto& target = dest[(bits * x) / 8];
+			target = uint8_t((target & ~mask) | ((data << shift) & mask));
+			break;
+		}
+		case DIBBitDepth::Bit8:
+		case DIBBitDepth::Bit16:
+		case DIBBitDepth::Bit24:
+		case DIBBitDepth::Bit32:
+		{
+			//	ピクセルデータはリトルエンディアンで格納する
+			for (auto i: Range<size_t>(0, pixellength).GetStdIterator()) { dest[(x * pixellength) + i] = uint8_t(data >> (8 * i)); }
+			break;
+		}
 		default: { throw InvalidOperationException("情報ヘッダのBitCountの内容が無効です。"); }
 	}
-	if (CurrentPos().X() == (size.Width() - 1))
-	{
-		size_t ci = size.Width() * pixellength;
-		for (auto i: Range<size_t>(ci, stridelength).GetStdIterator()) { DIBLoaderHelper::Write(loader, char(), offset + i); }
-	}
 	++current;
+	batch.Advance(current);
+}
+void DIBRGBEncoder::WriteRow(const RGB8_t* row, const DIBRowConverter& packer)
+{
+	if (!HasValue()) { throw std::out_of_range("現在の位置はこの画像領域を超えています。"); }
+	if ((current % size.Width()) != 0) { throw InvalidOperationException("現在の位置が水平ラインの先頭ではありません。"); }
+	if (packer.BitDepth() != bitdepth) { throw std::invalid_argument("packerの各ピクセルのデータ長がこのオブジェクトと一致しません。"); }
+	packer.Pack(row, batch.Row(current), size.Width());
+	current += size.Width();
+	batch.Advance(current);
+}
+void DIBRGBEncoder::Flush() { batch.Flush(current); }
+void DIBRGBEncoder::Reset()
+{
+	Flush();
+	batch.Reset();
+	current = 0;
 }
-void DIBRGBEncoder::Reset() { current = 0; }
 bool DIBRGBEncoder::HasValue() const { return (0 <= current)&&(current < length); }
 Graphics::DisplayPoint DIBRGBEncoder::CurrentPos() const { return ResolvePos(current); }
 bool DIBRGBEncoder::Equals(const DIBRGBEncoder& other) const { return current == other.current; }
@@ -199,8 +343,9 @@ size_t DIBRGBEncoder::ResolveOffset(const DisplayPoint& pos) const
 {
 	if ( (pos.X() < 0)||(pos.Y() < 0) ) { throw std::invalid_argument("posに指定されている座標が無効です。"); }
 	if ( (size.Width() <= pos.X())||(size.Height() <= pos.Y()) ) { throw std::out_of_range("指定された座標はこの画像領域を超えています。"); }
-	return (stridelength * (size.Height() - 1 - pos.Y())) + (pixellength * pos.X());
+	return (stridelength * (size.Height() - 1 - pos.Y())) + ((uint16_t(bitdepth) * size_t(pos.X())) / 8);
 }
 size_t DIBRGBEncoder::GetPxLength(DIBBitDepth bitdepth) { return (uint16_t(bitdepth) + 7) / 8; }
-size_t DIBRGBEncoder::GetStrideLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return (((GetPxLength(bitdepth) * size.Width()) + 3) / 4) * 4; }
+size_t DIBRGBEncoder::GetRowLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return ((uint16_t(bitdepth) * size_t(size.Width())) + 7) / 8; }
+size_t DIBRGBEncoder::GetStrideLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return ((GetRowLength(bitdepth, size) + 3) / 4) * 4; }
 size_t DIBRGBEncoder::GetImageLength(DIBBitDepth bitdepth, const DisplayRectSize& size) { return GetStrideLength(bitdepth, size) * size.Height(); }
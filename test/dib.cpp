@@ -18,9 +18,21 @@
 //
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <iterator>
 #include <chrono>
 #include <memory>
+#include <sstream>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
 #include "stationaryorbit/graphics-dib.bmpimage.hpp"
+#include "stationaryorbit/graphics-dib/dibv4bitmap.hpp"
+#include "stationaryorbit/graphics-dib/dibv5bitmap.hpp"
 #include "stationaryorbit/graphics-core.deformation.hpp"
 using namespace zawa_ch::StationaryOrbit;
 using namespace zawa_ch::StationaryOrbit::Graphics;
@@ -28,10 +40,125 @@ using namespace zawa_ch::StationaryOrbit::Graphics;
 RGB8Pixmap_t image;
 DIB::DIBInfoHeader ihead;
 
+///	0x00RRGGBB 形式の値から色を構築します。
+RGB8_t ToColor(uint32_t rgb)
+{
+	return RGB8_t(Proportion8_t((rgb >> 16) & 0xFF, 0xFF), Proportion8_t((rgb >> 8) & 0xFF, 0xFF), Proportion8_t(rgb & 0xFF, 0xFF));
+}
+///	ヘッダ・色テーブル(パレットまたはカラーマスク)・ピクセル配列からメモリ上にビットマップファイルを構築します。
+///	CoreHeader の色パレットは各要素の下位3バイト(RGBTriple)のみを格納します。
+template<class Header>
+DIB::DIBMemoryLoader BuildBitmap(const Header& header, const std::vector<uint32_t>& table, const std::vector<uint8_t>& pixels)
+{
+	constexpr size_t entrysize = (std::is_same_v<Header, DIB::DIBCoreHeader>)?(sizeof(DIB::RGBTriple_t)):(sizeof(uint32_t));
+	auto headersize = int32_t(Header::Size);
+	auto offset = sizeof(DIB::DIBFileHeader) + Header::Size + (entrysize * table.size());
+	auto fhead = DIB::DIBFileHeader();
+	std::copy(&(fhead.FileType_Signature[0]), &(fhead.FileType_Signature[2]), &(fhead.FileType[0]));
+	fhead.Offset(int32_t(offset));
+	fhead.FileSize(int32_t(offset + pixels.size()));
+	auto data = std::vector<char>(offset + pixels.size());
+	std::memcpy(data.data(), &fhead, sizeof(DIB::DIBFileHeader));
+	std::memcpy(data.data() + sizeof(DIB::DIBFileHeader), &headersize, sizeof(int32_t));
+	std::memcpy(data.data() + sizeof(DIB::DIBFileHeader) + sizeof(int32_t), &header, sizeof(Header));
+	for (auto i: Range<size_t>(0, table.size()).GetStdIterator()) { std::memcpy(data.data() + sizeof(DIB::DIBFileHeader) + Header::Size + (entrysize * i), &table[i], entrysize); }
+	if (!pixels.empty()) { std::memcpy(data.data() + offset, pixels.data(), pixels.size()); }
+	return DIB::DIBMemoryLoader(std::move(data));
+}
+
+///	ヘッダの種類を確認してビットマップを構築し、 @a action を呼び出します。
+template<class Action>
+void WithInfoBitmap(DIB::DIBLoader& loader, Action action)
+{
+	switch(loader.HeaderSize())
+	{
+		case DIB::DIBInfoHeader::Size:
+		{
+			auto bitmap = DIB::DIBInfoBitmap(std::move(loader));
+			action(bitmap);
+			break;
+		}
+		default: { throw std::runtime_error("Can't read file."); }
+	}
+}
+///	基準の画像の @a area の範囲と、 @a get で取得した色を比較します。
+///	@a get には @a area の左上を原点とする座標が渡されます。
+template<class Getter>
+void CompareImage(const Image<RGB8_t>& expected, const DisplayRectangle& area, Getter get, const char* message)
+{
+	for (auto y: Range<int>(0, area.Height()).GetStdIterator()) for (auto x: Range<int>(0, area.Width()).GetStdIterator())
+	{
+		if (get(DisplayPoint(x, y)) != expected.At(DisplayPoint(area.Left() + x, area.Top() + y))) { throw std::runtime_error(message); }
+	}
+}
+///	元の画像を指定したビット幅でメモリ上に書き込み、読み込み結果として期待される画像とともに返します。
+std::pair<DIB::DIBMemoryLoader, RGB8Pixmap_t> GenerateSample(DIB::DIBBitDepth bitcount)
+{
+	auto whead = ihead;
+	whead.Compression = DIB::DIBCompressionMethod::RGB;
+	whead.BitCount = bitcount;
+	whead.SizeImage = DIB::DIBRGBEncoder::GetImageLength(whead.BitCount, DisplayRectSize(whead.Width, whead.Height));
+	auto loader = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(loader), whead, image);
+	if (bitcount != DIB::DIBBitDepth::Bit16) { return { std::move(loader), image }; }
+	// 16ビットでは各チャネルが5ビットに丸められる
+	auto expected = RGB8Pixmap_t::Convert<RGB8_t>(image, [](const RGB8_t from)-> RGB8_t { return DIB::DIBPixelPerser::ToRGB(DIB::DIBPixelPerser::ToPixel16(from)); });
+	return { std::move(loader), expected };
+}
+///	入力ファイルと、ビット幅を変えてメモリ上に生成したビットマップのそれぞれについて @a action を呼び出します。
+///	@a action にはビットマップと、その読み込み結果として期待される画像が渡されます。
+template<class Action>
+void ForEachSample(Action action)
+{
+	auto file = DIB::DIBFileLoader("input.bmp", std::ios_base::in | std::ios_base::binary);
+	WithInfoBitmap(file, [&](DIB::DIBInfoBitmap& bitmap) { action(bitmap, image); });
+	for (auto bitcount: { DIB::DIBBitDepth::Bit16, DIB::DIBBitDepth::Bit32 })
+	{
+		auto sample = GenerateSample(bitcount);
+		WithInfoBitmap(sample.first, [&](DIB::DIBInfoBitmap& bitmap) { action(bitmap, sample.second); });
+	}
+}
+///	領域を指定した読み込みの比較に使用する領域を取得します。
+///	画像全体・内側の領域・右下端の1ピクセル・1水平ライン・1垂直ラインを含みます。
+std::vector<DisplayRectangle> SampleAreas(const DisplayRectSize& size)
+{
+	auto w = size.Width();
+	auto h = size.Height();
+	return { DisplayRectangle(0, 0, w, h), DisplayRectangle(w / 3, h / 4, w / 2, h / 2), DisplayRectangle(w - 1, h - 1, 1, 1), DisplayRectangle(0, h / 2, w, 1), DisplayRectangle(w / 2, 0, 1, h) };
+}
+
 void Read();
+void ReadCached();
+void ReadMapped();
+void ReadParallel();
+void ReadPositional();
+void ReadPositionalConcurrent();
+void ReadCursor();
+void ReadRegion();
+void ReadTiled();
+void ReadView();
+void ReadUnchecked();
+void ReadScanline();
+void ReadStreamed();
+void ReadPushed();
+void ReadScanlineLimits();
+void ReadPacked();
+void ReadIndexed8();
+void ReadBitFields();
+void ConvertKernels();
+void PackIndexed();
 void Write();
+void WriteMemory();
+void WriteParallel();
+void WritePositional();
+void WriteVectored();
+void WriteScanline();
+void WriteStreamed();
+void DecodeTyped();
 void Write16();
+void Read16();
 void WriteCoreProfile();
+void ReadCoreIndexed();
 void FripV();
 void FripH();
 void TurnR();
@@ -51,21 +178,161 @@ void Test_DIB()
 	elapsed = std::chrono::steady_clock::now() - start;
 	std::cout << "File read: " << elapsed.count() << "sec." << std::endl;
 
+	start = std::chrono::steady_clock::now();
+	ReadCached();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read through block cache: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadMapped();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read with mapping: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadParallel();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read in parallel: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadPositional();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read with positional I/O in parallel: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadPositionalConcurrent();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Concurrent positional reads: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadCursor();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read with cursor: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadRegion();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read region: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadTiled();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read with tile cache: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadView();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read through view: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadUnchecked();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Unchecked read: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadScanline();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read by scanline: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadStreamed();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Stream read by scanline: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadPushed();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Push decode: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadScanlineLimits();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Scanline header limits: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadPacked();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Packed 1/4bit read: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadIndexed8();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "8bit indexed read: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ReadBitFields();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Bitfields read and write: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ConvertKernels();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Row conversion kernels (" << DIB::DIBRowConverter::KernelName() << "): " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	PackIndexed();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Indexed row packing: " << elapsed.count() << "sec." << std::endl;
+
 	start = std::chrono::steady_clock::now();
 	Write();
 	elapsed = std::chrono::steady_clock::now() - start;
 	std::cout << "File write: " << elapsed.count() << "sec." << std::endl;
 
+	start = std::chrono::steady_clock::now();
+	WriteMemory();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Memory write and read: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	WriteParallel();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File write in parallel: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	WritePositional();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File write with positional I/O: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	WriteVectored();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Vectored write: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	WriteScanline();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Memory write by scanline: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	WriteStreamed();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Stream write: " << elapsed.count() << "sec." << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	DecodeTyped();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Typed decode: " << elapsed.count() << "sec." << std::endl;
+
 	start = std::chrono::steady_clock::now();
 	Write16();
 	elapsed = std::chrono::steady_clock::now() - start;
 	std::cout << "File write at 16bit: " << elapsed.count() << "sec." << std::endl;
 
+	start = std::chrono::steady_clock::now();
+	Read16();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "File read at 16bit: " << elapsed.count() << "sec." << std::endl;
+
 	start = std::chrono::steady_clock::now();
 	WriteCoreProfile();
 	elapsed = std::chrono::steady_clock::now() - start;
 	std::cout << "File write with CoreHeader Profile: " << elapsed.count() << "sec." << std::endl;
 
+	start = std::chrono::steady_clock::now();
+	ReadCoreIndexed();
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Indexed read with CoreHeader: " << elapsed.count() << "sec." << std::endl;
+
 	start = std::chrono::steady_clock::now();
 	FripV();
 	elapsed = std::chrono::steady_clock::now() - start;
@@ -124,19 +391,747 @@ void Read()
 	// ファイルを開く
 	auto loader = DIB::DIBFileLoader(ifile, std::ios_base::in | std::ios_base::binary);
 	// ビットマップをロードする
-	switch(loader.HeaderSize())
+	WithInfoBitmap(loader, [](DIB::DIBInfoBitmap& bitmap)
 	{
-		case DIB::DIBInfoHeader::Size:
+		ihead = bitmap.InfoHead();
+		image = bitmap.ToPixmap();
+	});
+}
+
+void ReadCached()
+{
+	const char* ifile = "input.bmp";
+	// 比較のためにファイル全体を読み込む
+	auto stream = std::ifstream(ifile, std::ios_base::in | std::ios_base::binary);
+	auto expected = std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	auto loader = DIB::DIBFileLoader(ifile, std::ios_base::in | std::ios_base::binary);
+	auto read = [&](size_t pos, size_t length)
+	{
+		auto actual = std::vector<char>(length);
+		loader.Read(actual.data(), pos, length);
+		if (!std::equal(actual.begin(), actual.end(), expected.begin() + pos)) { throw std::runtime_error("Cached read result mismatch."); }
+	};
+	auto check = [&](size_t hit, size_t miss)
+	{
+		if ((loader.CacheStatistics().Hit != hit)||(loader.CacheStatistics().Miss != miss)) { throw std::runtime_error("Cache statistics mismatch."); }
+	};
+	// 16バイトのブロックを4個まで保持するキャッシュで、既知のパターンの読み込みを行う
+	loader.SetCache(16, 4);
+	read(0, 4);
+	check(0, 1);
+	read(4, 4);
+	check(1, 1);
+	// ブロックの境界をまたぐ読み込みは両方のブロックを参照する
+	read(12, 8);
+	check(2, 2);
+	// ブロック長以上の読み込みはキャッシュを経由しない
+	read(32, 16);
+	check(2, 2);
+	// 3ブロックを新たに読み込み、最も長く使用されていないブロック0を追い出す
+	read(32, 1);
+	read(48, 1);
+	read(64, 1);
+	check(2, 5);
+	read(1, 1);
+	check(2, 6);
+	// ブロック0の再読み込みでブロック1が追い出されている
+	read(20, 1);
+	check(2, 7);
+	// 追い出されていないブロック3はキャッシュから読み込まれる
+	read(50, 1);
+	check(3, 7);
+	// ブロック数に0を指定するとキャッシュは無効になる
+	loader.ResetCacheStatistics();
+	loader.SetCache(16, 0);
+	read(0, 4);
+	read(4, 4);
+	read(12, 8);
+	check(0, 0);
+}
+
+void ReadMapped()
+{
+	const char* ifile = "input.bmp";
+	// ファイルをマップする
+	auto loader = DIB::DIBMappedFileLoader(ifile);
+	// ビットマップをロードし、通常の読み込みと結果を比較する
+	WithInfoBitmap(loader, [](DIB::DIBInfoBitmap& bitmap)
+	{
+		auto mapped = bitmap.ToPixmap();
+		CompareImage(image, DisplayRectangle(DisplayPoint(0, 0), image.Size()), [&](const DisplayPoint& p) { return mapped.At(p); }, "Mapped read result mismatch.");
+	});
+}
+
+void ReadParallel()
+{
+	const char* ifile = "input.bmp";
+	// ハードウェアのスレッド数でビットマップをロードし、通常の読み込みと結果を比較する
+	ForEachSample([](DIB::DIBInfoBitmap& bitmap, const Image<RGB8_t>& expected)
+	{
+		bitmap.SetDecodeConcurrency(0);
+		auto loaded = bitmap.ToPixmap();
+		CompareImage(expected, DisplayRectangle(DisplayPoint(0, 0), expected.Size()), [&](const DisplayPoint& p) { return loaded.At(p); }, "Parallel read result mismatch.");
+	});
+	// 帯単位のデコードで実際に使用されたスレッド数を確認する
+	auto size = image.Size();
+	auto converter = DIB::DIBRowConverter(ihead.BitCount);
+	auto decode = [&](DIB::DIBLoader& reader, int32_t y0, int32_t y1, RGB8_t* dest) { DIB::DIBRGBDecoder(reader, reader.FileHead().Offset(), ihead.BitCount, size).DecodeRows(y0, y1, dest, converter); };
+	auto sink = [&](int32_t y, const RGB8_t* row)
+	{
+		for (auto x: Range<int>(0, size.Width()).GetStdIterator()) { if (row[x] != image.At(DisplayPoint(x, y))) { throw std::runtime_error("Band decode result mismatch."); } }
+	};
+	auto bands = size_t((size.Height() + DIB::DIBBandDecodeHelper::BandHeight - 1) / DIB::DIBBandDecodeHelper::BandHeight);
+	auto named = DIB::DIBFileLoader(ifile, std::ios_base::in | std::ios_base::binary);
+	if (DIB::DIBBandDecodeHelper::Decode(named, size.Width(), 0, size.Height(), 2, decode, sink) != std::min<size_t>(2, bands)) { throw std::runtime_error("Band decode thread count mismatch."); }
+	// ファイル名を持たないローダーは独立した読み込みを構築できないため、呼び出し元のスレッドのみでデコードされる
+	auto unnamed = DIB::DIBFileLoader(std::fstream(ifile, std::ios_base::in | std::ios_base::binary));
+	if (DIB::DIBBandDecodeHelper::Decode(unnamed, size.Width(), 0, size.Height(), 2, decode, sink) != 1) { throw std::runtime_error("Band decode fallback mismatch."); }
+}
+
+void ReadPositional()
+{
+	const char* ifile = "input.bmp";
+	// 位置指定の入出力でファイルを開く
+	auto loader = DIB::DIBPositionalFileLoader(ifile);
+	// ハードウェアのスレッド数でビットマップをロードし、通常の読み込みと結果を比較する
+	WithInfoBitmap(loader, [](DIB::DIBInfoBitmap& bitmap)
+	{
+		bitmap.SetDecodeConcurrency(0);
+		auto loaded = bitmap.ToPixmap();
+		CompareImage(image, DisplayRectangle(DisplayPoint(0, 0), image.Size()), [&](const DisplayPoint& p) { return loaded.At(p); }, "Positional read result mismatch.");
+	});
+}
+
+void ReadPositionalConcurrent()
+{
+	const char* ifile = "input.bmp";
+	// 比較用にファイル全体を読み込む
+	auto stream = std::ifstream(ifile, std::ios_base::in | std::ios_base::binary);
+	auto expected = std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	// 1つのローダーに対して複数のスレッドから異なる位置・長さの読み込みを同時に行う
+	auto loader = DIB::DIBPositionalFileLoader(ifile);
+	const size_t threadcount = 8;
+	const size_t iterations = 256;
+	auto failed = std::atomic<bool>(false);
+	auto threads = std::vector<std::thread>();
+	for (auto t: Range<size_t>(0, threadcount).GetStdIterator())
+	{
+		threads.emplace_back([&, t]()
+		{
+			auto buffer = std::vector<char>();
+			for (auto i: Range<size_t>(0, iterations).GetStdIterator())
+			{
+				auto length = 1 + (((t * 131) + (i * 977)) % 4093);
+				auto pos = (((t * 7919) + (i * 104729)) % (expected.size() - length + 1));
+				buffer.resize(length);
+				try { loader.Read(buffer.data(), pos, length); }
+				catch (...) { failed = true; return; }
+				if (!std::equal(buffer.begin(), buffer.end(), expected.begin() + pos)) { failed = true; return; }
+			}
+		});
+	}
+	for (auto& thread: threads) { thread.join(); }
+	if (failed) { throw std::runtime_error("Concurrent positional read result mismatch."); }
+}
+
+void ReadCursor()
+{
+	// カーソルで1ピクセルずつ読み込み、通常の読み込みと結果を比較する
+	ForEachSample([](DIB::DIBInfoBitmap& bitmap, const Image<RGB8_t>& expected)
+	{
+		auto cursor = bitmap.Cursor();
+		CompareImage(expected, DisplayRectangle(DisplayPoint(0, 0), expected.Size()), [&](const DisplayPoint& p) { return cursor.Get(p); }, "Cursor read result mismatch.");
+	});
+}
+
+void ReadRegion()
+{
+	// 画像の一部の領域をロードし、通常の読み込みと結果を比較する
+	ForEachSample([](DIB::DIBInfoBitmap& bitmap, const Image<RGB8_t>& expected)
+	{
+		for (const auto& area: SampleAreas(expected.Size()))
+		{
+			auto loaded = bitmap.ToPixmap(area);
+			CompareImage(expected, area, [&](const DisplayPoint& p) { return loaded.At(p); }, "Region read result mismatch.");
+		}
+	});
+}
+
+void ReadTiled()
+{
+	const char* ifile = "input.bmp";
+	// ファイルを開く
+	auto loader = DIB::DIBFileLoader(ifile, std::ios_base::in | std::ios_base::binary);
+	// タイルのキャッシュを有効にして同じ領域を2回ロードし、通常の読み込みと結果を比較する
+	WithInfoBitmap(loader, [](DIB::DIBInfoBitmap& bitmap)
+	{
+		// 領域が複数のタイルにまたがるよう、小さいタイルを使用する
+		const int32_t tilesize = 64;
+		bitmap.SetTileCache(DIB::DIBTileCache::DefaultCapacity, tilesize);
+		auto area = DisplayRectangle(image.Size().Width() / 4, image.Size().Height() / 4, image.Size().Width() / 2, image.Size().Height() / 2);
+		auto tiles = size_t(((area.Right() - 1) / tilesize) - (area.Left() / tilesize) + 1) * size_t(((area.Bottom() - 1) / tilesize) - (area.Top() / tilesize) + 1);
+		auto first = bitmap.ToPixmap(area);
+		CompareImage(image, area, [&](const DisplayPoint& p) { return first.At(p); }, "Tiled read result mismatch.");
+		// 1回目はすべてのタイルがデコードされる
+		if ((bitmap.TileCacheStatistics().Hit != 0)||(bitmap.TileCacheStatistics().Miss != tiles)) { throw std::runtime_error("Tile cache statistics mismatch after first read."); }
+		auto second = bitmap.ToPixmap(area);
+		CompareImage(image, area, [&](const DisplayPoint& p) { return second.At(p); }, "Tiled read result mismatch.");
+		// 2回目はすべてのタイルがキャッシュから取得される
+		if ((bitmap.TileCacheStatistics().Hit != tiles)||(bitmap.TileCacheStatistics().Miss != tiles)||(bitmap.TileCacheStatistics().Eviction != 0)) { throw std::runtime_error("Tile cache statistics mismatch after second read."); }
+	});
+	// キャッシュされたタイルに含まれる位置へ書き込み、書き込んだ色が読み込まれることを確認する
+	auto sample = GenerateSample(DIB::DIBBitDepth::Bit24);
+	auto expected = sample.second;
+	auto bitmap = DIB::DIBInfoBitmap(std::move(sample.first));
+	bitmap.SetTileCache(DIB::DIBTileCache::DefaultCapacity, 64);
+	auto whole = DisplayRectangle(DisplayPoint(0, 0), expected.Size());
+	(void)bitmap.ToPixmap(whole);
+	auto misses = bitmap.TileCacheStatistics().Miss;
+	// 1ピクセルの書き込み
+	auto single = DisplayPoint(70, 10);
+	bitmap.SetPixel(single, ToColor(0x123456));
+	expected.At(single) = ToColor(0x123456);
+	if (bitmap.GetPixel(single) != ToColor(0x123456)) { throw std::runtime_error("Tiled read returned stale pixel after write."); }
+	// 書き込みによって破棄されたタイルは再度デコードされる
+	if (bitmap.TileCacheStatistics().Miss != (misses + 1)) { throw std::runtime_error("Tile cache was not invalidated by pixel write."); }
+	misses = bitmap.TileCacheStatistics().Miss;
+	// 水平ラインの末尾から1つ上の水平ラインの先頭へ続く書き込み(ファイル上の並び順)
+	auto width = expected.Size().Width();
+	auto span = std::vector<RGB8_t>();
+	for (auto i: Range<uint32_t>(0, 6).GetStdIterator()) { span.push_back(ToColor(0x102030 * (i + 1))); }
+	bitmap.SetPixel(DisplayPoint(width - 3, 64), span);
+	for (auto i: Range<int>(0, 3).GetStdIterator())
+	{
+		expected.At(DisplayPoint(width - 3 + i, 64)) = span[i];
+		expected.At(DisplayPoint(i, 63)) = span[3 + i];
+	}
+	if (bitmap.GetPixel(DisplayPoint(width - 1, 64)) != span[2]) { throw std::runtime_error("Tiled read returned stale pixel after span write."); }
+	if (bitmap.GetPixel(DisplayPoint(0, 63)) != span[3]) { throw std::runtime_error("Tiled read returned stale pixel after span write."); }
+	if (bitmap.TileCacheStatistics().Miss <= misses) { throw std::runtime_error("Tile cache was not invalidated by span write."); }
+	auto rewritten = bitmap.ToPixmap(whole);
+	CompareImage(expected, whole, [&](const DisplayPoint& p) { return rewritten.At(p); }, "Tiled read result mismatch after write.");
+	auto area = DisplayRectangle(width - 8, 60, 8, 8);
+	auto region = bitmap.ToPixmap(area);
+	CompareImage(expected, area, [&](const DisplayPoint& p) { return region.At(p); }, "Tiled region read result mismatch after write.");
+}
+
+void ReadView()
+{
+	// ビットマップを展開せずに Image として参照し、通常の読み込みと結果を比較する
+	ForEachSample([](DIB::DIBInfoBitmap& bitmap, const Image<RGB8_t>& expected)
+	{
+		auto view = bitmap.View();
+		const Image<RGB8_t>& viewed = view;
+		CompareImage(expected, DisplayRectangle(DisplayPoint(0, 0), expected.Size()), [&](const DisplayPoint& p) { return viewed.At(p); }, "View read result mismatch.");
+	});
+	auto loader = DIB::DIBFileLoader("input.bmp", std::ios_base::in | std::ios_base::binary);
+	WithInfoBitmap(loader, [](DIB::DIBInfoBitmap& bitmap)
+	{
+		auto view = bitmap.View();
+		// 複数のスレッドから同時に異なる水平ラインを参照しても、正しい色が取得される
+		auto errors = std::atomic<size_t>(0);
+		auto workers = std::vector<std::thread>();
+		for (auto t: Range<int>(0, 4).GetStdIterator())
+		{
+			workers.emplace_back([&, t]()
+			{
+				for (auto y = t; y < image.Size().Height(); y += 4) for (auto x: Range<int>(0, image.Size().Width()).GetStdIterator())
+				{
+					if (view.At(DisplayPoint(x, y)) != image.At(DisplayPoint(x, y))) { ++errors; }
+				}
+			});
+		}
+		for (auto& i: workers) { i.join(); }
+		if (errors != 0) { throw std::runtime_error("Concurrent view read result mismatch."); }
+		// ビューを書き込み元とする場合、単一のスレッドでは画像と同じ内容が書き込まれ、複数のスレッドは拒否される
+		auto expected = DIB::DIBMemoryLoader();
+		DIB::DIBInfoBitmap::Generate(std::move(expected), ihead, image);
+		auto generated = DIB::DIBMemoryLoader();
+		DIB::DIBInfoBitmap::Generate(std::move(generated), ihead, view);
+		if (generated.Buffer() != expected.Buffer()) { throw std::runtime_error("Write from view result mismatch."); }
+		try
 		{
+			auto parallel = DIB::DIBMemoryLoader();
+			DIB::DIBInfoBitmap::Generate(std::move(parallel), ihead, view, 0);
+			throw std::runtime_error("Parallel write from view accepted.");
+		}
+		catch (std::invalid_argument&) {}
+	});
+}
+void ReadUnchecked()
+{
+	auto check = [](DIB::DIBLoader& loader, DIB::DIBBitDepth bitcount)
+	{
+		auto size = image.Size();
+		auto converter = DIB::DIBRowConverter(bitcount);
+		auto decoder = DIB::DIBRGBDecoder(loader, loader.FileHead().Offset(), bitcount, size);
+		// 画像領域を超える領域は検証の時点で拒否される
+		for (const auto& area: { DisplayRectangle(-1, 0, 1, 1), DisplayRectangle(0, -1, 1, 1), DisplayRectangle(0, 0, size.Width() + 1, 1), DisplayRectangle(0, size.Height() - 1, 1, 2), DisplayRectangle(size.Width(), 0, 1, 1), DisplayRectangle(4, 4, -1, 1) })
+		{
+			try
+			{
+				decoder.ValidateRegion(area);
+				throw std::runtime_error("Out of range region accepted.");
+			}
+			catch (std::out_of_range&) {}
+		}
+		// 検証した領域の内側では、範囲の検査を行わない読み込みと検査を行う読み込みの結果が一致する
+		for (const auto& area: SampleAreas(size))
+		{
+			decoder.ValidateRegion(area);
+			auto pixels = size_t(area.Width()) * area.Height();
+			auto checked = std::vector<RGB8_t>(pixels);
+			auto unchecked = std::vector<RGB8_t>(pixels);
+			decoder.DecodeRegion(area, checked.data(), converter);
+			decoder.DecodeRegionUnchecked(area, unchecked.data(), converter);
+			if (checked != unchecked) { throw std::runtime_error("Unchecked region read result mismatch."); }
+			auto rows = size_t(area.Height());
+			auto checkedrows = std::vector<RGB8_t>(size_t(size.Width()) * rows);
+			auto uncheckedrows = std::vector<RGB8_t>(size_t(size.Width()) * rows);
+			decoder.DecodeRows(area.Top(), area.Bottom(), checkedrows.data(), converter);
+			decoder.DecodeRowsUnchecked(area.Top(), area.Bottom(), uncheckedrows.data(), converter);
+			if (checkedrows != uncheckedrows) { throw std::runtime_error("Unchecked rows read result mismatch."); }
+			auto checkedraw = std::vector<uint8_t>(decoder.StrideLength() * rows);
+			auto uncheckedraw = std::vector<uint8_t>(decoder.StrideLength() * rows);
+			decoder.ReadRows(area.Top(), area.Bottom(), checkedraw.data());
+			decoder.ReadRowsUnchecked(area.Top(), area.Bottom(), uncheckedraw.data());
+			if (checkedraw != uncheckedraw) { throw std::runtime_error("Unchecked raw rows read result mismatch."); }
+		}
+		// カーソルでも同様に、範囲の検査を行わない取得と検査を行う取得の結果が一致する
+		WithInfoBitmap(loader, [&](DIB::DIBInfoBitmap& bitmap)
+		{
+			auto cursor = bitmap.Cursor();
+			try
+			{
+				cursor.ValidateRegion(DisplayRectangle(0, 0, size.Width() + 1, size.Height()));
+				throw std::runtime_error("Out of range region accepted by cursor.");
+			}
+			catch (std::out_of_range&) {}
+			for (const auto& area: SampleAreas(size))
+			{
+				cursor.ValidateRegion(area);
+				for (auto y: Range<int>(area.Top(), area.Bottom()).GetStdIterator()) for (auto x: Range<int>(area.Left(), area.Right()).GetStdIterator())
+				{
+					if (cursor.GetUnchecked(DisplayPoint(x, y)) != cursor.Get(DisplayPoint(x, y))) { throw std::runtime_error("Unchecked cursor read result mismatch."); }
+				}
+			}
+		});
+	};
+	auto file = DIB::DIBFileLoader("input.bmp", std::ios_base::in | std::ios_base::binary);
+	check(file, ihead.BitCount);
+	for (auto bitcount: { DIB::DIBBitDepth::Bit16, DIB::DIBBitDepth::Bit32 })
+	{
+		auto sample = GenerateSample(bitcount);
+		check(sample.first, bitcount);
+	}
+}
+
+void ReadScanline()
+{
+	const char* ifile = "input.bmp";
+	// ファイルを開く
+	auto loader = DIB::DIBFileLoader(ifile, std::ios_base::in | std::ios_base::binary);
+	// 水平ラインを先頭から順に読み込み、通常の読み込みと結果を比較する
+	auto reader = DIB::DIBScanlineReader(loader);
+	while (reader.Next())
+	{
+		auto y = reader.CurrentY();
+		for (auto x: Range<int>(0, reader.Size().Width()).GetStdIterator())
+		{
+			if (reader.Current()[x] != image.At(DisplayPoint(x, y))) { throw std::runtime_error("Scanline read result mismatch."); }
+		}
+	}
+	if (reader.RowsRead() != image.Size().Height()) { throw std::runtime_error("Scanline read row count mismatch."); }
+}
+
+void ReadStreamed()
+{
+	const char* ifile = "input.bmp";
+	// シークを行わずにストリームの先頭から順に読み込む
+	auto stream = std::ifstream(ifile, std::ios_base::in | std::ios_base::binary);
+	auto loader = DIB::DIBStreamLoader(stream);
+	auto reader = DIB::DIBScanlineReader(loader);
+	while (reader.Next())
+	{
+		auto y = reader.CurrentY();
+		for (auto x: Range<int>(0, reader.Size().Width()).GetStdIterator())
+		{
+			if (reader.Current()[x] != image.At(DisplayPoint(x, y))) { throw std::runtime_error("Stream read result mismatch."); }
+		}
+	}
+	if (reader.RowsRead() != image.Size().Height()) { throw std::runtime_error("Stream read row count mismatch."); }
+}
+
+void ReadPushed()
+{
+	const char* ifile = "input.bmp";
+	// ファイルを開く
+	auto stream = std::ifstream(ifile, std::ios_base::in | std::ios_base::binary);
+	// 分割したデータを順に渡し、デコードされた水平ラインを通常の読み込みと比較する
+	auto decoder = DIB::DIBPushDecoder([](int32_t y, const RGB8_t* row)
+	{
+		for (auto x: Range<int>(0, image.Size().Width()).GetStdIterator())
+		{
+			if (row[x] != image.At(DisplayPoint(x, y))) { throw std::runtime_error("Push decode result mismatch."); }
+		}
+	});
+	char chunk[1500];
+	while (stream.read(chunk, sizeof(chunk)) || (0 < stream.gcount())) { decoder.Feed(chunk, size_t(stream.gcount())); }
+	if (!decoder.IsCompleted()) { throw std::runtime_error("Push decode row count mismatch."); }
+}
+
+void ReadScanlineLimits()
+{
+	auto makehead = [](int32_t width, int32_t height, DIB::DIBBitDepth bitcount)
+	{
+		auto head = DIB::DIBInfoHeader();
+		head.Width = width;
+		head.Height = height;
+		head.Planes = 1;
+		head.BitCount = bitcount;
+		head.Compression = DIB::DIBCompressionMethod::RGB;
+		return head;
+	};
+	// ヘッダのみのデータを Load と DIBPushDecoder の双方に渡し、いずれもヘッダの時点で拒否されることを確認する
+	auto rejected = [](const DIB::DIBInfoHeader& head, size_t maxstridelength)
+	{
+		auto loader = BuildBitmap(head, {}, {});
+		auto loadrejected = false;
+		try { auto format = DIB::DIBScanlineFormat::Load(loader, maxstridelength); }
+		catch (const DIB::InvalidDIBFormatException&) { loadrejected = true; }
+		auto called = false;
+		auto decoder = DIB::DIBPushDecoder([&](int32_t, const RGB8_t*) { called = true; }, maxstridelength);
+		auto pushrejected = false;
+		try { decoder.Feed(loader.Buffer().data(), loader.Buffer().size()); }
+		catch (const DIB::InvalidDIBFormatException&) { pushrejected = true; }
+		if (loadrejected != pushrejected) { throw std::runtime_error("Scanline header validation mismatch between Load and push decoder."); }
+		if (called) { throw std::runtime_error("Push decoder called handler for rejected header."); }
+		return loadrejected;
+	};
+	// 無効な BitCount
+	for (auto bitcount: { DIB::DIBBitDepth::Null, DIB::DIBBitDepth(2), DIB::DIBBitDepth(48) })
+	{
+		if (!rejected(makehead(4, 4, bitcount), DIB::DIBScanlineFormat::DefaultMaxStrideLength)) { throw std::runtime_error("Invalid BitCount was not rejected."); }
+	}
+	auto bitfields = makehead(4, 4, DIB::DIBBitDepth::Bit24);
+	bitfields.Compression = DIB::DIBCompressionMethod::BITFIELDS;
+	if (!rejected(bitfields, DIB::DIBScanlineFormat::DefaultMaxStrideLength)) { throw std::runtime_error("Invalid BitFields BitCount was not rejected."); }
+	// 横幅・縦幅が0の画像
+	if (!rejected(makehead(0, std::numeric_limits<int32_t>::max(), DIB::DIBBitDepth::Bit24), DIB::DIBScanlineFormat::DefaultMaxStrideLength)) { throw std::runtime_error("Zero width was not rejected."); }
+	if (!rejected(makehead(4, 0, DIB::DIBBitDepth::Bit24), DIB::DIBScanlineFormat::DefaultMaxStrideLength)) { throw std::runtime_error("Zero height was not rejected."); }
+	// 既定の上限を超える横幅
+	if (!rejected(makehead(std::numeric_limits<int32_t>::max(), 1, DIB::DIBBitDepth::Bit24), DIB::DIBScanlineFormat::DefaultMaxStrideLength)) { throw std::runtime_error("Huge width was not rejected."); }
+	// 呼び出し元が指定した上限 横幅33の24ビット画像の1水平ラインは100バイト
+	if (!rejected(makehead(33, 2, DIB::DIBBitDepth::Bit24), 99)) { throw std::runtime_error("Stride over caller limit was not rejected."); }
+	if (rejected(makehead(33, 2, DIB::DIBBitDepth::Bit24), 100)) { throw std::runtime_error("Stride within caller limit was rejected."); }
+	auto loader = BuildBitmap(makehead(33, 2, DIB::DIBBitDepth::Bit24), {}, std::vector<uint8_t>(200));
+	auto reader = DIB::DIBScanlineReader(loader, DIB::DIBScanlineReader::DefaultRowCount, 100);
+	if (reader.Format().StrideLength != 100) { throw std::runtime_error("Scanline stride length mismatch."); }
+}
+
+void ReadPacked()
+{
+	for (auto bitcount: { DIB::DIBBitDepth::Bit1, DIB::DIBBitDepth::Bit4 })
+	{
+		auto bits = size_t(uint16_t(bitcount));
+		auto colors = size_t(1) << bits;
+		// パレットの準備
+		auto palette = std::vector<uint32_t>();
+		for (auto i: Range<uint32_t>(0, colors).GetStdIterator()) { palette.push_back((((i * 16) + 1) << 16) | ((255 - (i * 16)) << 8) | (i * 5)); }
+		// 1バイトに収まらない幅や、末尾のバイトが途中で終わる幅を含めて確認する
+		for (auto width: { 1, 7, 9, 33 })
+		{
+			const int height = 3;
+			auto index = [&](int x, int y) { return size_t((x * 3) + (y * 5)) % colors; };
+			// ピクセル配列の準備 末尾の未使用のビットとパディングは1で埋め、読み込まれないことを確認する
+			auto stride = (((bits * width) + 31) / 32) * 4;
+			auto pixels = std::vector<uint8_t>(stride * height, 0xFF);
+			for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator())
+			{
+				auto& data = pixels[(stride * (height - 1 - y)) + ((bits * x) / 8)];
+				auto shift = 8 - bits - ((bits * x) % 8);
+				data = uint8_t((data & ~(((1U << bits) - 1) << shift)) | (index(x, y) << shift));
+			}
+			auto head = DIB::DIBInfoHeader();
+			head.Width = width;
+			head.Height = height;
+			head.Planes = 1;
+			head.BitCount = bitcount;
+			head.Compression = DIB::DIBCompressionMethod::RGB;
+			head.SizeImage = uint32_t(pixels.size());
+			auto loader = BuildBitmap(head, palette, pixels);
 			auto bitmap = DIB::DIBInfoBitmap(std::move(loader));
-			ihead = bitmap.InfoHead();
-			image = bitmap.ToPixmap();
-			break;
+			// 行単位の変換・ピクセル単位の読み込み・バイトの途中から始まる領域の読み込みを比較する
+			auto loaded = bitmap.ToPixmap();
+			auto cursor = bitmap.Cursor();
+			auto area = DisplayRectangle(width / 2, 1, width - (width / 2), height - 1);
+			auto region = bitmap.ToPixmap(area);
+			for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator())
+			{
+				auto expected = ToColor(palette[index(x, y)]);
+				if (loaded.At(DisplayPoint(x, y)) != expected) { throw std::runtime_error("Packed row read result mismatch."); }
+				if (cursor.Get(DisplayPoint(x, y)) != expected) { throw std::runtime_error("Packed pixel read result mismatch."); }
+				if ((area.Left() <= x)&&(area.Top() <= y)&&(region.At(DisplayPoint(x - area.Left(), y - area.Top())) != expected)) { throw std::runtime_error("Packed region read result mismatch."); }
+			}
 		}
-		default: { throw std::runtime_error("Can't read file."); }
 	}
 }
 
+void ReadIndexed8()
+{
+	// 256色に満たない色パレットを持つ8ビットのビットマップを準備する
+	const int width = 37;
+	const int height = 3;
+	const uint32_t clrused = 5;
+	auto palette = std::vector<uint32_t>{ 0x00000000, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00808080 };
+	auto index = [&](int x, int y) { return uint8_t(size_t(x + (y * 2)) % clrused); };
+	auto stride = ((size_t(width) + 3) / 4) * 4;
+	auto pixels = std::vector<uint8_t>(stride * height, 0xFF);
+	for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator()) { pixels[(stride * (height - 1 - y)) + x] = index(x, y); }
+	auto head = DIB::DIBInfoHeader();
+	head.Width = width;
+	head.Height = height;
+	head.Planes = 1;
+	head.BitCount = DIB::DIBBitDepth::Bit8;
+	head.Compression = DIB::DIBCompressionMethod::RGB;
+	head.SizeImage = uint32_t(pixels.size());
+	head.ClrUsed = clrused;
+	{
+		auto loader = BuildBitmap(head, palette, pixels);
+		auto bitmap = DIB::DIBInfoBitmap(std::move(loader));
+		if ((!bitmap.Palette().has_value())||(bitmap.Palette()->get().size() != clrused)) { throw std::runtime_error("8bit palette size mismatch."); }
+		auto loaded = bitmap.ToPixmap();
+		auto cursor = bitmap.Cursor();
+		for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator())
+		{
+			auto expected = ToColor(palette[index(x, y)]);
+			if (loaded.At(DisplayPoint(x, y)) != expected) { throw std::runtime_error("8bit row read result mismatch."); }
+			if (cursor.Get(DisplayPoint(x, y)) != expected) { throw std::runtime_error("8bit pixel read result mismatch."); }
+		}
+	}
+	// ClrUsed 以上のインデックスは行単位・ピクセル単位のいずれの読み込みでも InvalidDIBFormatException となる
+	for (auto invalid: { uint8_t(clrused), uint8_t(255) })
+	{
+		auto corrupted = pixels;
+		corrupted[(stride * (height - 1 - 1)) + (width - 1)] = invalid;
+		auto loader = BuildBitmap(head, palette, corrupted);
+		auto bitmap = DIB::DIBInfoBitmap(std::move(loader));
+		auto rejected = false;
+		try { (void)bitmap.ToPixmap(); }
+		catch (const DIB::InvalidDIBFormatException&) { rejected = true; }
+		if (!rejected) { throw std::runtime_error("8bit out of range index was not rejected by row read."); }
+		rejected = false;
+		auto cursor = bitmap.Cursor();
+		try { (void)cursor.Get(DisplayPoint(width - 1, 1)); }
+		catch (const DIB::InvalidDIBFormatException&) { rejected = true; }
+		if (!rejected) { throw std::runtime_error("8bit out of range index was not rejected by pixel read."); }
+		// 範囲外のインデックスを含まない行は読み込むことができる
+		auto area = DisplayRectangle(0, 0, width, 1);
+		auto row = bitmap.ToPixmap(area);
+		for (auto x: Range<int>(0, width).GetStdIterator())
+		{
+			if (row.At(DisplayPoint(x, 0)) != ToColor(palette[index(x, 0)])) { throw std::runtime_error("8bit valid row read result mismatch."); }
+		}
+	}
+}
+
+void ReadBitFields()
+{
+	// 色マスク・ピクセルの値・手で計算した色(0x00RRGGBB)からビットマップを構築し、読み込んだ結果と比較する
+	// 書き込んだ色が想定したピクセルの値として格納され、再度読み込めることも確認する
+	// InfoHeader では色マスクを情報ヘッダの直後に、 V4・V5 ヘッダではヘッダ内に格納する
+	auto check = [](auto head, DIB::DIBBitDepth bitcount, DIB::DIBCompressionMethod compression, const std::vector<uint32_t>& masks, const std::vector<uint32_t>& values, const std::vector<uint32_t>& expected, uint32_t written, uint32_t writtenraw, const char* message)
+	{
+		const int width = int(values.size());
+		const int height = 2;
+		auto length = size_t(uint16_t(bitcount) / 8);
+		auto stride = (((length * width) + 3) / 4) * 4;
+		// 2行目は1行目を左右反転した並びとする
+		auto value = [&](int x, int y) { return (y == 0)?(x):(width - 1 - x); };
+		auto pixels = std::vector<uint8_t>(stride * height);
+		for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator())
+		{
+			for (auto b: Range<size_t>(0, length).GetStdIterator()) { pixels[(stride * (height - 1 - y)) + (length * x) + b] = uint8_t(values[value(x, y)] >> (8 * b)); }
+		}
+		typedef decltype(head) Header;
+		typedef std::conditional_t<std::is_same_v<Header, DIB::DIBInfoHeader>, DIB::DIBInfoBitmap, std::conditional_t<std::is_same_v<Header, DIB::DIBV4Header>, DIB::DIBV4Bitmap, DIB::DIBV5Bitmap>> Bitmap;
+		head.Width = width;
+		head.Height = height;
+		head.Planes = 1;
+		head.BitCount = bitcount;
+		head.Compression = compression;
+		head.SizeImage = uint32_t(pixels.size());
+		auto table = masks;
+		if constexpr (!std::is_same_v<Header, DIB::DIBInfoHeader>)
+		{
+			head.ColorMask = DIB::DIBRGBAColorMask{ masks[0], masks[1], masks[2], (3 < masks.size())?(masks[3]):(0) };
+			table.clear();
+		}
+		auto loader = BuildBitmap(head, table, pixels);
+		auto bitmap = Bitmap(std::move(loader));
+		auto loaded = bitmap.ToPixmap();
+		auto cursor = bitmap.Cursor();
+		for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator())
+		{
+			auto color = ToColor(expected[value(x, y)]);
+			if (loaded.At(DisplayPoint(x, y)) != color) { throw std::runtime_error(message); }
+			if (cursor.Get(DisplayPoint(x, y)) != color) { throw std::runtime_error(message); }
+		}
+		bitmap.SetPixel(DisplayPoint(0, 1), ToColor(written));
+		if (bitmap.GetPixelRaw(DisplayPoint(0, 1)) != writtenraw) { throw std::runtime_error(message); }
+		if (bitmap.GetPixel(DisplayPoint(0, 1)) != ToColor(written)) { throw std::runtime_error(message); }
+	};
+	// 5-6-5: 各チャネルは上位ビットの複製で8ビットに拡張される
+	check(DIB::DIBInfoHeader(), DIB::DIBBitDepth::Bit16, DIB::DIBCompressionMethod::BITFIELDS, { 0xF800, 0x07E0, 0x001F },
+		{ 0x0000, 0xFFFF, 0xAE69, 0xF800, 0x07E0, 0x001F, 0x8410 },
+		{ 0x000000, 0xFFFFFF, 0xADCF4A, 0xFF0000, 0x00FF00, 0x0000FF, 0x848284 },
+		0xADCF4A, 0xAE69, "565 bitfields result mismatch.");
+	// チャネルの間に未使用のビットがある 4-4-4 の配置: 未使用のビットは色に影響しない
+	check(DIB::DIBInfoHeader(), DIB::DIBBitDepth::Bit16, DIB::DIBCompressionMethod::BITFIELDS, { 0xF000, 0x0780, 0x001E },
+		{ 0xAAF9, 0x0861, 0xF79E, 0x5302 },
+		{ 0xAA55CC, 0x000000, 0xFFFFFF, 0x556611 },
+		0xAA55CC, 0xA298, "Sparse bitfields result mismatch.");
+	// α成分を持つ 2-10-10-10: 10ビットのチャネルは上位8ビットに切り詰められ、α成分は色に影響しない
+	// 書き込んだピクセルのα成分は不透明となる
+	check(DIB::DIBInfoHeader(), DIB::DIBBitDepth::Bit32, DIB::DIBCompressionMethod::ALPHABITFIELDS, { 0x3FF00000, 0x000FFC00, 0x000003FF, 0xC0000000 },
+		{ 0xFFC800FC, 0x00000000, 0x3FFFFFFF, 0x4AB55A5A, 0x80000401 },
+		{ 0xFF803F, 0x000000, 0xFFFFFF, 0x2A5596, 0x000000 },
+		0xFF803F, 0xFFC800FC, "Alpha bitfields result mismatch.");
+	// V4・V5 ヘッダ内の色マスクを使用する
+	check(DIB::DIBV4Header(), DIB::DIBBitDepth::Bit16, DIB::DIBCompressionMethod::BITFIELDS, { 0xF800, 0x07E0, 0x001F },
+		{ 0x0000, 0xFFFF, 0xAE69, 0xF800, 0x07E0, 0x001F, 0x8410 },
+		{ 0x000000, 0xFFFFFF, 0xADCF4A, 0xFF0000, 0x00FF00, 0x0000FF, 0x848284 },
+		0xADCF4A, 0xAE69, "V4 565 bitfields result mismatch.");
+	check(DIB::DIBV5Header(), DIB::DIBBitDepth::Bit16, DIB::DIBCompressionMethod::BITFIELDS, { 0xF000, 0x0780, 0x001E },
+		{ 0xAAF9, 0x0861, 0xF79E, 0x5302 },
+		{ 0xAA55CC, 0x000000, 0xFFFFFF, 0x556611 },
+		0xAA55CC, 0xA298, "V5 sparse bitfields result mismatch.");
+	check(DIB::DIBV4Header(), DIB::DIBBitDepth::Bit32, DIB::DIBCompressionMethod::ALPHABITFIELDS, { 0x3FF00000, 0x000FFC00, 0x000003FF, 0xC0000000 },
+		{ 0xFFC800FC, 0x00000000, 0x3FFFFFFF, 0x4AB55A5A, 0x80000401 },
+		{ 0xFF803F, 0x000000, 0xFFFFFF, 0x2A5596, 0x000000 },
+		0xFF803F, 0xFFC800FC, "V4 alpha bitfields result mismatch.");
+	// BITFIELDS ではヘッダ内のα成分のマスクは使用されず、書き込んだピクセルにもα成分は格納されない
+	for (auto alphamask: { uint32_t(0xFF000000), uint32_t(0xF00000F0) })
+	{
+		check(DIB::DIBV5Header(), DIB::DIBBitDepth::Bit32, DIB::DIBCompressionMethod::BITFIELDS, { 0x00FF0000, 0x0000FF00, 0x000000FF, alphamask },
+			{ 0xFF123456, 0x00ABCDEF, 0x80FFFFFF },
+			{ 0x123456, 0xABCDEF, 0xFFFFFF },
+			0x123456, 0x00123456, "V5 bitfields with alpha mask result mismatch.");
+	}
+	// ビットが連続していない色マスクは構築時に InvalidDIBFormatException となる
+	auto head = DIB::DIBInfoHeader();
+	head.Width = 1;
+	head.Height = 1;
+	head.Planes = 1;
+	head.BitCount = DIB::DIBBitDepth::Bit16;
+	head.Compression = DIB::DIBCompressionMethod::BITFIELDS;
+	head.SizeImage = 4;
+	auto loader = BuildBitmap(head, { 0xF00F, 0x07E0, 0x0010 }, std::vector<uint8_t>(4));
+	auto rejected = false;
+	try { auto bitmap = DIB::DIBInfoBitmap(std::move(loader)); }
+	catch (const DIB::InvalidDIBFormatException&) { rejected = true; }
+	if (!rejected) { throw std::runtime_error("Non-contiguous bitfields was not rejected."); }
+}
+
+void ConvertKernels()
+{
+	typedef DIB::DIBRowConverter::KernelSelection KernelSelection;
+	// ベクトル長の前後と端数を含む幅で、SIMD命令を使用しない実装と実行環境で選択された実装を比較する
+	for (auto width: { 1, 15, 16, 17, 31 })
+	{
+		auto count = size_t(width);
+		auto src = std::vector<uint8_t>(count * 4);
+		for (auto i: Range<size_t>(0, src.size()).GetStdIterator()) { src[i] = uint8_t((i * 37) + (i >> 3) + 11); }
+		// 変換先の末尾に番兵を置き、範囲外に書き込まれないことを確認する
+		auto sentinel = ToColor(0x00A55A3C);
+		auto compare = [&](auto convert, const char* message)
+		{
+			auto scalar = std::vector<RGB8_t>(count + 1, sentinel);
+			auto dispatched = std::vector<RGB8_t>(count + 1, sentinel);
+			convert(src.data(), scalar.data(), count, KernelSelection::Scalar);
+			convert(src.data(), dispatched.data(), count, KernelSelection::Dispatched);
+			if ((scalar != dispatched)||(dispatched[count] != sentinel)) { throw std::runtime_error(message); }
+		};
+		compare(DIB::DIBRowConverter::ConvertBGR24, "BGR24 kernel result mismatch.");
+		compare(DIB::DIBRowConverter::ConvertBGRX32, "BGRX32 kernel result mismatch.");
+		compare(DIB::DIBRowConverter::ConvertRGB555, "RGB555 kernel result mismatch.");
+		compare(DIB::DIBRowConverter::ConvertRGB565, "RGB565 kernel result mismatch.");
+		// SIMD命令を使用しない実装の結果を手で計算した値と比較する
+		auto colors = std::vector<RGB8_t>(count);
+		DIB::DIBRowConverter::ConvertBGR24(src.data(), colors.data(), count, KernelSelection::Scalar);
+		for (auto i: Range<size_t>(0, count).GetStdIterator())
+		{
+			if (colors[i] != ToColor((uint32_t(src[(i * 3) + 2]) << 16) | (uint32_t(src[(i * 3) + 1]) << 8) | src[i * 3])) { throw std::runtime_error("BGR24 scalar result mismatch."); }
+		}
+		DIB::DIBRowConverter::ConvertBGRX32(src.data(), colors.data(), count, KernelSelection::Scalar);
+		for (auto i: Range<size_t>(0, count).GetStdIterator())
+		{
+			if (colors[i] != ToColor((uint32_t(src[(i * 4) + 2]) << 16) | (uint32_t(src[(i * 4) + 1]) << 8) | src[i * 4])) { throw std::runtime_error("BGRX32 scalar result mismatch."); }
+		}
+		// 16ビットへの変換も同様に比較する
+		auto packcompare = [&](auto pack, const char* message)
+		{
+			auto scalar = std::vector<uint8_t>((count * 2) + 1, 0xA5);
+			auto dispatched = std::vector<uint8_t>((count * 2) + 1, 0xA5);
+			pack(colors.data(), scalar.data(), count, KernelSelection::Scalar);
+			pack(colors.data(), dispatched.data(), count, KernelSelection::Dispatched);
+			if ((scalar != dispatched)||(dispatched[count * 2] != 0xA5)) { throw std::runtime_error(message); }
+		};
+		packcompare(DIB::DIBRowConverter::PackRGB555, "RGB555 pack kernel result mismatch.");
+		packcompare(DIB::DIBRowConverter::PackRGB565, "RGB565 pack kernel result mismatch.");
+	}
+}
+void PackIndexed()
+{
+	// 1ビット: 白黒の色パレットで、中間の色は近い方に変換される
+	{
+		auto palette = std::vector<RGB8_t>{ ToColor(0x000000), ToColor(0xFFFFFF) };
+		auto converter = DIB::DIBRowConverter(DIB::DIBBitDepth::Bit1, palette);
+		auto row = std::vector<RGB8_t>{ ToColor(0xFFFFFF), ToColor(0x101010), ToColor(0xF0E0D0), ToColor(0x000000), ToColor(0x7F7F7F), ToColor(0x808080), ToColor(0xFFFFFF), ToColor(0x203040), ToColor(0xC0C0C0) };
+		auto packed = std::vector<uint8_t>(3, 0xA5);
+		converter.Pack(row.data(), packed.data(), row.size());
+		if ((packed[0] != 0xA6)||(packed[1] != 0x80)||(packed[2] != 0xA5)) { throw std::runtime_error("1bit packed data mismatch."); }
+	}
+	// 4ビット: 色パレットに含まれる色は同じインデックスに変換され、逆変換で元の色に戻る
+	{
+		auto palette = std::vector<RGB8_t>{ ToColor(0x000000), ToColor(0xFF0000), ToColor(0x00FF00), ToColor(0x0000FF), ToColor(0xFFFFFF) };
+		auto converter = DIB::DIBRowConverter(DIB::DIBBitDepth::Bit4, palette);
+		auto row = std::vector<RGB8_t>{ palette[4], palette[1], palette[0], palette[3], palette[2], palette[2], palette[1] };
+		auto packed = std::vector<uint8_t>(5, 0xA5);
+		converter.Pack(row.data(), packed.data(), row.size());
+		if ((packed[0] != 0x41)||(packed[1] != 0x03)||(packed[2] != 0x22)||(packed[3] != 0x10)||(packed[4] != 0xA5)) { throw std::runtime_error("4bit packed data mismatch."); }
+		auto colors = std::vector<RGB8_t>(row.size());
+		converter.Convert(packed.data(), colors.data(), row.size());
+		if (colors != row) { throw std::runtime_error("4bit round trip mismatch."); }
+	}
+	// 8ビット: 色パレットに無い色は最も近い色のインデックスになる
+	{
+		auto palette = std::vector<RGB8_t>{ ToColor(0x000000), ToColor(0x808080), ToColor(0xFF0000), ToColor(0xFFFFFF) };
+		auto converter = DIB::DIBRowConverter(DIB::DIBBitDepth::Bit8, palette);
+		auto row = std::vector<RGB8_t>{ ToColor(0xE01010), ToColor(0x707880), ToColor(0xF8F8F8), ToColor(0x080000), ToColor(0x808080) };
+		auto packed = std::vector<uint8_t>(row.size() + 1, 0xA5);
+		converter.Pack(row.data(), packed.data(), row.size());
+		if (packed != std::vector<uint8_t>{ 2, 1, 3, 0, 1, 0xA5 }) { throw std::runtime_error("8bit packed data mismatch."); }
+	}
+	// 色パレットを持たないインデックスカラーの変換は構築時に拒否される
+	try
+	{
+		auto converter = DIB::DIBRowConverter(DIB::DIBBitDepth::Bit8);
+		throw std::runtime_error("Indexed converter without palette accepted.");
+	}
+	catch (std::invalid_argument&) {}
+	// 空の色パレットでは変換できない
+	try
+	{
+		auto converter = DIB::DIBRowConverter(DIB::DIBBitDepth::Bit4, std::vector<RGB8_t>());
+		auto row = std::vector<RGB8_t>{ ToColor(0x000000) };
+		auto packed = std::vector<uint8_t>(1);
+		converter.Pack(row.data(), packed.data(), row.size());
+		throw std::runtime_error("Packing with empty palette accepted.");
+	}
+	catch (InvalidOperationException&) {}
+}
+
 void Write()
 {
 	const char* ofile = "output.bmp";
@@ -146,6 +1141,252 @@ void Write()
 	DIB::DIBInfoBitmap::Generate(std::move(loader), ihead, image);
 }
 
+void WriteMemory()
+{
+	// メモリ上にビットマップを書き込む
+	auto loader = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(loader), ihead, image);
+	// 書き込んだバッファを参照してビットマップをロードし、元の画像と比較する
+	auto view = DIB::DIBMemoryLoader(loader.Buffer().data(), loader.Buffer().size());
+	auto bitmap = DIB::DIBInfoBitmap(std::move(view));
+	auto loaded = bitmap.ToPixmap();
+	for (auto y: Range<int>(0, image.Size().Height()).GetStdIterator()) for (auto x: Range<int>(0, image.Size().Width()).GetStdIterator())
+	{
+		if (loaded.At(DisplayPoint(x, y)) != image.At(DisplayPoint(x, y))) { throw std::runtime_error("Memory read result mismatch."); }
+	}
+}
+
+void WriteParallel()
+{
+	// 逐次書き込みと並列書き込みをメモリ上で行う
+	auto sequential = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(sequential), ihead, image);
+	auto parallel = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(parallel), ihead, image, 0);
+	// 書き込まれたデータを比較する
+	if (sequential.Buffer() != parallel.Buffer()) { throw std::runtime_error("Parallel write result mismatch."); }
+}
+
+void WritePositional()
+{
+	const char* ofile = "output_positional.bmp";
+	// メモリ上と、位置指定の入出力によるファイルへの書き込みを行う
+	auto generated = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(generated), ihead, image);
+	{
+		auto loader = DIB::DIBPositionalFileLoader(ofile, std::ios_base::out | std::ios_base::binary);
+		DIB::DIBInfoBitmap::Generate(std::move(loader), ihead, image);
+	}
+	// ファイルに書き込まれたデータを比較する
+	auto loader = DIB::DIBPositionalFileLoader(ofile);
+	auto written = std::vector<char>(generated.Buffer().size());
+	loader.Read(written.data(), 0, written.size());
+	if (written != generated.Buffer()) { throw std::runtime_error("Positional write result mismatch."); }
+}
+
+void WriteVectored()
+{
+	const char* ofile = "output_vectored.bin";
+	const size_t length = 8192;
+	// IOV_MAX(Linux では1024)を超える数の領域を用意する
+	const size_t runcount = 3000;
+	auto pattern = std::vector<char>(length);
+	for (auto i: Range<size_t>(0, length).GetStdIterator()) { pattern[i] = char((i * 37) + 11); }
+	// 2バイトずつ連続する領域と長さ0の領域を交互に並べ、その後に離れた位置と手前の位置への領域を置く
+	auto segments = std::vector<DIB::DIBWriteSegment>();
+	for (auto i: Range<size_t>(0, runcount).GetStdIterator())
+	{
+		auto pos = 100 + (i * 2);
+		segments.push_back(DIB::DIBWriteSegment{ pattern.data() + pos, pos, 2 });
+		segments.push_back(DIB::DIBWriteSegment{ pattern.data(), pos + 2, 0 });
+	}
+	segments.push_back(DIB::DIBWriteSegment{ pattern.data() + 7000, 7000, 50 });
+	segments.push_back(DIB::DIBWriteSegment{ pattern.data() + 20, 20, 10 });
+	segments.push_back(DIB::DIBWriteSegment{ pattern.data(), length + 100, 0 });
+	auto expected = std::vector<char>(length, char(0x5A));
+	for (const auto& segment: segments) { std::copy(segment.Source, segment.Source + segment.Length, expected.begin() + segment.Position); }
+	auto prepare = [&]()
+	{
+		auto stream = std::ofstream(ofile, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		stream.write(std::vector<char>(length, char(0x5A)).data(), length);
+	};
+	// 書き込み後にローダーから読み込み、期待される内容と比較する
+	auto check = [&](DIB::DIBLoader& loader, const char* message)
+	{
+		auto written = std::vector<char>(length);
+		loader.Read(written.data(), 0, length);
+		if (written != expected) { throw std::runtime_error(message); }
+	};
+	{
+		auto loader = DIB::DIBMemoryLoader(std::vector<char>(length, char(0x5A)));
+		loader.WriteV(segments);
+		check(loader, "Memory vectored write result mismatch.");
+	}
+	prepare();
+	{
+		auto loader = DIB::DIBFileLoader(ofile, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+		// 書き込み前に読み込んでキャッシュに載せ、書き込みによって破棄されることを確認する
+		auto cached = std::vector<char>(length);
+		loader.Read(cached.data(), 0, length);
+		loader.WriteV(segments);
+		check(loader, "File vectored write result mismatch.");
+	}
+	prepare();
+	{
+		auto loader = DIB::DIBMappedFileLoader(ofile, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+		loader.WriteV(segments);
+		check(loader, "Mapped vectored write result mismatch.");
+		// 範囲外の領域を含む場合は、いずれの領域も書き込まれない
+		auto outside = std::vector<DIB::DIBWriteSegment>{ DIB::DIBWriteSegment{ pattern.data(), 0, 10 }, DIB::DIBWriteSegment{ pattern.data(), length - 1, 2 } };
+		auto rejected = false;
+		try { loader.WriteV(outside); }
+		catch (const std::out_of_range&) { rejected = true; }
+		if (!rejected) { throw std::runtime_error("Mapped vectored write out of range was not rejected."); }
+		check(loader, "Mapped vectored write modified data on failure.");
+	}
+	prepare();
+	{
+		auto loader = DIB::DIBPositionalFileLoader(ofile, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+		loader.WriteV(segments);
+		check(loader, "Positional vectored write result mismatch.");
+	}
+	// 出力ストリームには先頭から隙間なく続く領域と、間を空けた領域を順に書き込む
+	auto sequential = std::vector<DIB::DIBWriteSegment>();
+	for (auto i: Range<size_t>(0, runcount).GetStdIterator())
+	{
+		sequential.push_back(DIB::DIBWriteSegment{ pattern.data() + (i * 2), i * 2, 2 });
+		sequential.push_back(DIB::DIBWriteSegment{ pattern.data(), (i + 1) * 2, 0 });
+	}
+	auto gapped = std::vector<DIB::DIBWriteSegment>{ DIB::DIBWriteSegment{ pattern.data() + 7000, 7000, 50 } };
+	auto streamed = std::vector<char>(pattern.begin(), pattern.begin() + (runcount * 2));
+	streamed.resize(7000, 0);
+	streamed.insert(streamed.end(), pattern.begin() + 7000, pattern.begin() + 7050);
+	{
+		// ファイル記述子への書き込みは writev で行われる
+		auto fd = ::open(ofile, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+		if (fd < 0) { throw std::runtime_error("Can't open file."); }
+		auto loader = DIB::DIBOutputStreamLoader(fd);
+		loader.WriteV(sequential);
+		if (loader.Position() != (runcount * 2)) { ::close(fd); throw std::runtime_error("Descriptor vectored write position mismatch."); }
+		loader.WriteV(gapped);
+		::close(fd);
+		auto stream = std::ifstream(ofile, std::ios_base::in | std::ios_base::binary);
+		auto written = std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+		if (written != streamed) { throw std::runtime_error("Descriptor vectored write result mismatch."); }
+	}
+	{
+		auto output = std::ostringstream(std::ios_base::out | std::ios_base::binary);
+		auto loader = DIB::DIBOutputStreamLoader(output);
+		loader.WriteV(sequential);
+		loader.WriteV(gapped);
+		auto outdata = output.str();
+		if (std::vector<char>(outdata.begin(), outdata.end()) != streamed) { throw std::runtime_error("Stream vectored write result mismatch."); }
+	}
+}
+
+void WriteScanline()
+{
+	// 書き込み器はSizeImageを計算して格納するため、比較用の一括書き込みでも同じ値を指定する
+	auto whead = ihead;
+	whead.SizeImage = DIB::DIBRGBEncoder::GetImageLength(whead.BitCount, DisplayRectSize(whead.Width, whead.Height));
+	auto generated = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(generated), whead, image);
+	// 水平ラインを画像上の並び順とファイル上の並び順のそれぞれで書き込み、一括書き込みとバイト単位で比較する
+	for (auto order: { DIB::DIBScanlineOrder::Logical, DIB::DIBScanlineOrder::File })
+	{
+		auto streamed = DIB::DIBMemoryLoader();
+		{
+			auto writer = DIB::DIBScanlineWriter(streamed, ihead, order);
+			auto row = std::vector<RGB8_t>(image.Size().Width());
+			auto expectedy = (order == DIB::DIBScanlineOrder::File)?(image.Size().Height() - 1):(0);
+			while (!writer.IsCompleted())
+			{
+				auto y = writer.NextY();
+				if (y != expectedy) { throw std::runtime_error("Scanline write order mismatch."); }
+				expectedy += (order == DIB::DIBScanlineOrder::File)?(-1):(1);
+				for (auto x: Range<int>(0, image.Size().Width()).GetStdIterator()) { row[x] = image.At(DisplayPoint(x, y)); }
+				writer.WriteRow(row);
+			}
+			writer.Close();
+		}
+		if (streamed.Buffer() != generated.Buffer()) { throw std::runtime_error("Scanline write result mismatch."); }
+	}
+}
+
+void WriteStreamed()
+{
+	// シークを行わずにストリームの先頭から順に書き込む
+	auto stream = std::ostringstream(std::ios_base::out | std::ios_base::binary);
+	auto loader = DIB::DIBOutputStreamLoader(stream);
+	{
+		auto writer = DIB::DIBScanlineWriter(loader, ihead);
+		writer.WriteImage(image, 0);
+		writer.Close();
+	}
+	// 書き込まれた画像を読み込み、比較する
+	auto data = stream.str();
+	auto reader = DIB::DIBMemoryLoader(std::vector<char>(data.begin(), data.end()));
+	auto written = DIB::DIBInfoBitmap(std::move(reader)).ToPixmap();
+	for (auto y: Range<int>(0, image.Size().Height()).GetStdIterator()) for (auto x: Range<int>(0, image.Size().Width()).GetStdIterator())
+	{
+		if (written.At(DisplayPoint(x, y)) != image.At(DisplayPoint(x, y))) { throw std::runtime_error("Stream write result mismatch."); }
+	}
+	// Generate は書き込み専用のローダーにも書き込み、ビットマップを返さずに終了する
+	auto generated = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(generated), ihead, image);
+	for (auto concurrency: { size_t(1), size_t(0) })
+	{
+		auto output = std::ostringstream(std::ios_base::out | std::ios_base::binary);
+		auto outloader = DIB::DIBOutputStreamLoader(output);
+		if (DIB::DIBInfoBitmap::Generate(std::move(outloader), ihead, image, concurrency).has_value()) { throw std::runtime_error("Generate to write-only loader returned bitmap."); }
+		auto outdata = output.str();
+		if (std::vector<char>(outdata.begin(), outdata.end()) != generated.Buffer()) { throw std::runtime_error("Generate to stream result mismatch."); }
+	}
+}
+
+void DecodeTyped()
+{
+	// メモリ上にビットマップを書き込む
+	auto loader = DIB::DIBMemoryLoader();
+	DIB::DIBInfoBitmap::Generate(std::move(loader), ihead, image);
+	auto size = image.Size();
+	auto decoder = DIB::DIBRGBDecoder(loader, loader.FileHead().Offset(), ihead.BitCount, size);
+	// どちらの経路も全体の水平ラインを1回の読み込みで取得し、ピクセルの取り出し方のみが異なる
+	// 実行時のビット幅からピクセルごとに std::variant を構築して取り出す
+	auto start = std::chrono::steady_clock::now();
+	auto raw = std::vector<uint8_t>(decoder.StrideLength() * size.Height());
+	decoder.ReadRows(0, size.Height(), raw.data());
+	auto variant = std::vector<uint32_t>();
+	variant.reserve(size_t(size.Width()) * size.Height());
+	for (auto r: Range<size_t>(0, size_t(size.Height())).GetStdIterator()) for (auto x: Range<size_t>(0, size_t(size.Width())).GetStdIterator())
+	{
+		auto row = raw.data() + (decoder.StrideLength() * r);
+		auto value = DIB::DIBBitDepthDispatcher::Dispatch(ihead.BitCount, [&](auto depth) -> DIB::DIBRGBDecoder::ValueType { return DIB::DIBTypedLayout<decltype(depth)::value>::Extract(row, x); });
+		variant.push_back(std::visit([](auto i) { return uint32_t(i); }, value));
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Variant decode: " << elapsed.count() << "sec." << std::endl;
+	// ビット幅を静的に指定したデコーダーで、コンパイル時に解決された取り出しを行う
+	start = std::chrono::steady_clock::now();
+	auto typed = std::vector<uint32_t>();
+	DIB::DIBBitDepthDispatcher::Dispatch(ihead.BitCount, [&](auto depth)
+	{
+		auto pixels = std::vector<DIB::DIBPixelData<decltype(depth)::value>>(size_t(size.Width()) * size.Height());
+		decoder.Typed<decltype(depth)::value>().ReadRows(0, size.Height(), pixels.data());
+		typed.reserve(pixels.size());
+		for (const auto& i: pixels) { typed.push_back(uint32_t(i)); }
+	});
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Typed row decode: " << elapsed.count() << "sec." << std::endl;
+	// ファイル上の並び順(画像の下から上)と画像上の並び順を対応させて比較する
+	for (auto i: Range<size_t>(0, variant.size()).GetStdIterator())
+	{
+		auto y = size.Height() - 1 - int(i / size.Width());
+		auto x = int(i % size.Width());
+		if (variant[i] != typed[(size_t(y) * size.Width()) + x]) { throw std::runtime_error("Typed decode result mismatch."); }
+	}
+}
+
 void Write16()
 {
 	const char* ofile = "output16.bmp";
@@ -160,6 +1401,21 @@ void Write16()
 	DIB::DIBInfoBitmap::Generate(std::move(loader), whead, image);
 }
 
+void Read16()
+{
+	const char* ifile = "output16.bmp";
+	// ファイルを開く
+	auto loader = DIB::DIBFileLoader(ifile, std::ios_base::in | std::ios_base::binary);
+	// ビットマップをロードし、16ビットに変換した元の画像と比較する
+	auto bitmap = DIB::DIBInfoBitmap(std::move(loader));
+	auto loaded = bitmap.ToPixmap();
+	for (auto y: Range<int>(0, image.Size().Height()).GetStdIterator()) for (auto x: Range<int>(0, image.Size().Width()).GetStdIterator())
+	{
+		auto expected = DIB::DIBPixelPerser::ToRGB(DIB::DIBPixelPerser::ToPixel16(image.At(DisplayPoint(x, y))));
+		if (loaded.At(DisplayPoint(x, y)) != expected) { throw std::runtime_error("16bit read result mismatch."); }
+	}
+}
+
 void WriteCoreProfile()
 {
 	const char* ofile = "output_core.bmp";
@@ -173,6 +1429,67 @@ void WriteCoreProfile()
 	auto loader = DIB::DIBFileLoader(ofile, std::ios_base::out | std::ios_base::binary);
 	// ビットマップを書き込む
 	DIB::DIBCoreBitmap::Generate(std::move(loader), whead, image);
+	// 書き込んだファイルを開き直して読み込み、元の画像と比較する
+	auto reader = DIB::DIBFileLoader(ofile, std::ios_base::in | std::ios_base::binary);
+	auto bitmap = DIB::DIBCoreBitmap(std::move(reader));
+	auto loaded = bitmap.ToPixmap();
+	CompareImage(image, DisplayRectangle(DisplayPoint(0, 0), image.Size()), [&](const DisplayPoint& p) { return loaded.At(p); }, "Core read result mismatch.");
+	auto cursor = bitmap.Cursor();
+	CompareImage(image, DisplayRectangle(DisplayPoint(0, 0), image.Size()), [&](const DisplayPoint& p) { return cursor.Get(p); }, "Core pixel read result mismatch.");
+	for (const auto& area: SampleAreas(image.Size()))
+	{
+		auto region = bitmap.ToPixmap(area);
+		CompareImage(image, area, [&](const DisplayPoint& p) { return region.At(p); }, "Core region read result mismatch.");
+	}
+}
+
+void ReadCoreIndexed()
+{
+	// CoreHeader の色パレット(RGBTriple)を持つ1・4・8ビットのビットマップをメモリ上に構築し、読み込んだ結果と比較する
+	for (auto bitcount: { DIB::DIBBitDepth::Bit1, DIB::DIBBitDepth::Bit4, DIB::DIBBitDepth::Bit8 })
+	{
+		auto bits = size_t(uint16_t(bitcount));
+		auto colors = size_t(1) << bits;
+		auto palette = std::vector<uint32_t>();
+		for (auto i: Range<uint32_t>(0, colors).GetStdIterator()) { palette.push_back(((i * 7 + 3) % 256) << 16 | ((255 - i) << 8) | ((i * 13) % 256)); }
+		for (auto width: { 1, 9, 33 })
+		{
+			const int height = 3;
+			auto index = [&](int x, int y) { return size_t((x * 3) + (y * 5)) % colors; };
+			// 末尾の未使用のビットとパディングは1で埋め、読み込まれないことを確認する
+			auto stride = (((bits * width) + 31) / 32) * 4;
+			auto pixels = std::vector<uint8_t>(stride * height, 0xFF);
+			for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator())
+			{
+				auto& data = pixels[(stride * (height - 1 - y)) + ((bits * x) / 8)];
+				auto shift = 8 - bits - ((bits * x) % 8);
+				data = uint8_t((data & ~(((1U << bits) - 1) << shift)) | (index(x, y) << shift));
+			}
+			auto head = DIB::DIBCoreHeader();
+			head.Width = uint16_t(width);
+			head.Height = uint16_t(height);
+			head.Planes = 1;
+			head.BitCount = bitcount;
+			auto loader = BuildBitmap(head, palette, pixels);
+			auto bitmap = DIB::DIBCoreBitmap(std::move(loader));
+			if ((!bitmap.Palette().has_value())||(bitmap.Palette()->get().size() != colors)) { throw std::runtime_error("Core palette size mismatch."); }
+			for (auto i: Range<size_t>(0, colors).GetStdIterator())
+			{
+				if (bitmap.Palette()->get()[i] != ToColor(palette[i])) { throw std::runtime_error("Core palette result mismatch."); }
+			}
+			auto loaded = bitmap.ToPixmap();
+			auto cursor = bitmap.Cursor();
+			auto area = DisplayRectangle(width / 2, 1, width - (width / 2), height - 1);
+			auto region = bitmap.ToPixmap(area);
+			for (auto y: Range<int>(0, height).GetStdIterator()) for (auto x: Range<int>(0, width).GetStdIterator())
+			{
+				auto expected = ToColor(palette[index(x, y)]);
+				if (loaded.At(DisplayPoint(x, y)) != expected) { throw std::runtime_error("Core indexed row read result mismatch."); }
+				if (cursor.Get(DisplayPoint(x, y)) != expected) { throw std::runtime_error("Core indexed pixel read result mismatch."); }
+				if ((area.Left() <= x)&&(area.Top() <= y)&&(region.At(DisplayPoint(x - area.Left(), y - area.Top())) != expected)) { throw std::runtime_error("Core indexed region read result mismatch."); }
+			}
+		}
+	}
 }
 
 void FripV()